@@ -20,11 +20,15 @@
 #include <stdexcept>
 #include <assert.h>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <regex>
 #include <string>
@@ -32,6 +36,8 @@
 #include <variant>
 #include <vector>
 #include <set>
+#include <shared_mutex>
+#include <unordered_map>
 #include <filesystem>
 
 #if defined(_DEBUG)
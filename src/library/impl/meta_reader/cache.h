@@ -1,64 +1,84 @@
+namespace xlang::impl
+{
+    // Databases read from memory are passed to the cache either as a byte_view or as a pair of a name,
+    // reported by database::path(), and a byte_view.
+    template <typename T>
+    struct is_image : std::is_same<T, meta::reader::byte_view>
+    {
+    };
+
+    template <typename Name>
+    struct is_image<std::pair<Name, meta::reader::byte_view>> : std::true_type
+    {
+    };
+}
+
 
 namespace xlang::meta::reader
 {
+    struct cache_options
+    {
+        // Opens each database and collects its types on a separate task_group worker, and
+        // categorizes namespaces concurrently.
+        bool parallel{};
+
+        // Keeps decoded signatures in each database, see database::enable_signature_cache.
+        bool signatures{};
+
+        // Sorts the members of a namespace into interfaces, classes, etc. when one of those lists is
+        // first asked for rather than while the cache is built, so that namespaces a tool never
+        // looks at are never categorized. Type lookups through find() and the types map do not
+        // require it.
+        bool deferred{};
+
+        // Path of a snapshot of the indexed cache. If the snapshot is intact and matches the sizes,
+        // write times and metadata headers of the input files, it is mapped instead of indexing the
+        // databases; otherwise the cache is indexed as usual and the snapshot is rewritten. See
+        // snapshot.h for the format.
+        std::string snapshot;
+
+        // How database files are mapped into memory, see file_view_options.
+        file_view_options mapping;
+    };
+
     struct cache
     {
         cache() = default;
         cache(cache const&) = delete;
         cache& operator=(cache const&) = delete;
 
+        // Files are either paths or byte_views of memory owned by the caller, such as winmds packed
+        // inside a single mapped archive. A byte_view may be paired with a name that the database
+        // reports as its path; a plain byte_view has an empty path. Databases read from memory are
+        // not copied, so the memory must outlive the cache. Snapshots are only supported for paths.
         template<typename C, typename T = typename C::value_type>
-        explicit cache(C const& files)
+        explicit cache(C const& files, cache_options const& options = {}) : m_parallel{ options.parallel }
         {
-            for (auto&& file : files)
+            if constexpr (!impl::is_image<T>::value)
             {
-                auto& db = m_databases.emplace_back(file, this);
-
-                for (auto&& type : db.TypeDef)
+                if (!options.snapshot.empty())
                 {
-                    if (!type.Flags().WindowsRuntime())
+                    std::vector<std::string> const paths(std::begin(files), std::end(files));
+
+                    if (load_snapshot(paths, options))
                     {
-                        continue;
+                        return;
                     }
 
-                    auto& ns = m_namespaces[type.TypeNamespace()];
-                    ns.types.try_emplace(type.TypeName(), type);
+                    load(paths, options, true);
+                    index_types();
+                    categorize();
+                    save_snapshot(paths, options.snapshot);
+                    return;
                 }
             }
 
-            for (auto&&[namespace_name, members] : m_namespaces)
+            load(files, options, true);
+            index_types();
+
+            if (!options.deferred)
             {
-                for (auto&&[name, type] : members.types)
-                {
-                    switch (get_category(type))
-                    {
-                    case category::interface_type:
-                        members.interfaces.push_back(type);
-                        continue;
-                    case category::class_type:
-                        if (extends_type(type, "System"sv, "Attribute"sv))
-                        {
-                            members.attributes.push_back(type);
-                            continue;
-                        }
-                        members.classes.push_back(type);
-                        continue;
-                    case category::enum_type:
-                        members.enums.push_back(type);
-                        continue;
-                    case category::struct_type:
-                        if (get_attribute(type, "Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv))
-                        {
-                            members.contracts.push_back(type);
-                            continue;
-                        }
-                        members.structs.push_back(type);
-                        continue;
-                    case category::delegate_type:
-                        members.delegates.push_back(type);
-                        continue;
-                    }
-                }
+                categorize();
             }
         }
 
@@ -68,21 +88,8 @@ namespace xlang::meta::reader
 
         TypeDef find(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
         {
-            auto ns = m_namespaces.find(type_namespace);
-
-            if (ns == m_namespaces.end())
-            {
-                return {};
-            }
-
-            auto type = ns->second.types.find(type_name);
-
-            if (type == ns->second.types.end())
-            {
-                return {};
-            }
-
-            return type->second;
+            auto const entry = find_entry(type_namespace, type_name);
+            return entry ? get_type(*entry) : TypeDef{};
         }
 
         TypeDef find(std::string_view const& type_string) const
@@ -138,7 +145,7 @@ namespace xlang::meta::reader
             {
                 return;
             }
-            auto& members = m->second;
+            auto& members = m->second.get_categories();
 
             auto remove = [&](auto&& collection, auto&& name)
             {
@@ -160,23 +167,365 @@ namespace xlang::meta::reader
             remove(members.delegates, name);
         }
 
+        // The Windows Runtime types of a namespace. The lists by category are filled in when the
+        // cache is built or, with cache_options::deferred, when the first of them is asked for, which
+        // may happen on several threads at once.
         struct namespace_members
         {
             std::map<std::string_view, TypeDef> types;
-            std::vector<TypeDef> interfaces;
-            std::vector<TypeDef> classes;
-            std::vector<TypeDef> enums;
-            std::vector<TypeDef> structs;
-            std::vector<TypeDef> delegates;
-            std::vector<TypeDef> attributes;
-            std::vector<TypeDef> contracts;
+
+            std::vector<TypeDef> const& interfaces() const
+            {
+                return get_categories().interfaces;
+            }
+
+            std::vector<TypeDef> const& classes() const
+            {
+                return get_categories().classes;
+            }
+
+            std::vector<TypeDef> const& enums() const
+            {
+                return get_categories().enums;
+            }
+
+            std::vector<TypeDef> const& structs() const
+            {
+                return get_categories().structs;
+            }
+
+            std::vector<TypeDef> const& delegates() const
+            {
+                return get_categories().delegates;
+            }
+
+            std::vector<TypeDef> const& attributes() const
+            {
+                return get_categories().attributes;
+            }
+
+            std::vector<TypeDef> const& contracts() const
+            {
+                return get_categories().contracts;
+            }
+
+        private:
+
+            friend cache;
+
+            struct categories
+            {
+                std::vector<TypeDef> interfaces;
+                std::vector<TypeDef> classes;
+                std::vector<TypeDef> enums;
+                std::vector<TypeDef> structs;
+                std::vector<TypeDef> delegates;
+                std::vector<TypeDef> attributes;
+                std::vector<TypeDef> contracts;
+            };
+
+            categories& get_categories() const
+            {
+                std::call_once(m_categorize_once, [&] { categorize(); });
+                return m_categories;
+            }
+
+            void categorize() const;
+
+            mutable std::once_flag m_categorize_once;
+            mutable categories m_categories;
         };
 
         using namespace_type = std::pair<std::string_view const, namespace_members> const&;
 
     private:
 
+        friend database;
+
+        // Database is the position of the defining database in m_database_index plus one, or zero
+        // for an empty slot. Names are read from the database, so entries can be mapped in place.
+        struct type_index_entry
+        {
+            uint64_t hash;
+            uint32_t database;
+            uint32_t row;
+
+            explicit operator bool() const noexcept
+            {
+                return database != 0;
+            }
+        };
+
+        TypeDef get_type(type_index_entry const& entry) const noexcept
+        {
+            return { &m_database_index[entry.database - 1]->TypeDef, entry.row };
+        }
+
+        type_index_entry const* find_entry(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            auto const hash = impl::hash_type_name(type_namespace, type_name);
+
+            return m_type_index.find(hash, [&](type_index_entry const& entry)
+            {
+                if (entry.hash != hash)
+                {
+                    return false;
+                }
+
+                auto const type = get_type(entry);
+                return type.TypeName() == type_name && type.TypeNamespace() == type_namespace;
+            });
+        }
+
+        // Opens the databases in input order and, if collect_types is set, adds their Windows Runtime
+        // types to the namespace tables.
+        template <typename C>
+        void load(C const& files, cache_options const& options, bool const collect_types)
+        {
+            if (!options.parallel)
+            {
+                for (auto&& file : files)
+                {
+                    auto& db = open_database(m_databases, file, options);
+
+                    if (!collect_types)
+                    {
+                        continue;
+                    }
+
+                    for (auto&& type : db.TypeDef)
+                    {
+                        if (!type.Flags().WindowsRuntime())
+                        {
+                            continue;
+                        }
+
+                        auto& ns = m_namespaces[type.TypeNamespace()];
+                        ns.types.try_emplace(type.TypeName(), type);
+                    }
+                }
+
+                return;
+            }
+
+            struct loaded_type
+            {
+                std::string_view type_namespace;
+                std::string_view type_name;
+                TypeDef type;
+            };
+
+            struct loaded_database
+            {
+                std::list<database> db;
+                std::vector<loaded_type> types;
+            };
+
+            std::vector<loaded_database> loaded(std::size(files));
+            task_group group;
+            auto current = loaded.begin();
+
+            for (auto&& file : files)
+            {
+                group.add([&, &file = file, &result = *current++]
+                {
+                    auto& db = open_database(result.db, file, options);
+
+                    if (!collect_types)
+                    {
+                        return;
+                    }
+
+                    result.types.reserve(db.TypeDef.size());
+
+                    for (auto&& type : db.TypeDef)
+                    {
+                        if (type.Flags().WindowsRuntime())
+                        {
+                            result.types.push_back({ type.TypeNamespace(), type.TypeName(), type });
+                        }
+                    }
+                });
+            }
+
+            group.get();
+
+            // Merging in input order preserves the serial behavior where the first database
+            // that defines a type wins.
+            for (auto&& result : loaded)
+            {
+                m_databases.splice(m_databases.end(), result.db);
+
+                for (auto&& type : result.types)
+                {
+                    m_namespaces[type.type_namespace].types.try_emplace(type.type_name, type.type);
+                }
+            }
+        }
+
+        template <typename T>
+        database& open_database(std::list<database>& databases, T const& file, cache_options const& options) const
+        {
+            auto& db = [&]() -> database&
+            {
+                if constexpr (std::is_same_v<T, byte_view>)
+                {
+                    return databases.emplace_back(file, std::string_view{}, this);
+                }
+                else if constexpr (impl::is_image<T>::value)
+                {
+                    return databases.emplace_back(file.second, file.first, this);
+                }
+                else
+                {
+                    return databases.emplace_back(file, this, options.mapping);
+                }
+            }();
+
+            if (options.signatures)
+            {
+                db.enable_signature_cache();
+            }
+
+            return db;
+        }
+
+        static uint64_t get_fingerprint(database const& db) noexcept;
+        bool load_snapshot(std::vector<std::string> const& files, cache_options const& options);
+        void save_snapshot(std::vector<std::string> const& files, std::string const& path) const;
+
+        void index_databases()
+        {
+            m_database_index.clear();
+
+            for (auto&& db : m_databases)
+            {
+                m_database_index.push_back(&db);
+            }
+        }
+
+        void index_types()
+        {
+            index_databases();
+            std::map<database const*, uint32_t> positions;
+
+            for (auto&& db : m_database_index)
+            {
+                positions.emplace(db, static_cast<uint32_t>(positions.size() + 1));
+            }
+
+            size_t count{};
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                count += members.types.size();
+            }
+
+            if (!count)
+            {
+                return;
+            }
+
+            m_type_index.reset(m_type_index.get_capacity(count));
+
+            // Names are unique within the namespace tables, so no two entries ever match.
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                for (auto&&[name, type] : members.types)
+                {
+                    auto const hash = impl::hash_type_name(namespace_name, name);
+                    m_type_index.insert(hash, { hash, positions.at(&type.get_database()), type.index() }, [](auto&&) { return false; });
+                }
+            }
+        }
+
+        void categorize()
+        {
+            if (!m_parallel)
+            {
+                for (auto&&[namespace_name, members] : m_namespaces)
+                {
+                    members.get_categories();
+                }
+
+                return;
+            }
+
+            task_group group;
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                group.add([&members = members]
+                {
+                    members.get_categories();
+                });
+            }
+
+            group.get();
+        }
+
         std::list<database> m_databases;
+        std::vector<database const*> m_database_index;
+        impl::probe_table<type_index_entry> m_type_index;
+        std::unique_ptr<file_view> m_snapshot;
         std::map<std::string_view, namespace_members> m_namespaces;
+        bool m_parallel{};
     };
-}
\ No newline at end of file
+
+    inline void cache::namespace_members::categorize() const
+    {
+        for (auto&&[name, type] : types)
+        {
+            switch (get_category(type))
+            {
+            case category::interface_type:
+                m_categories.interfaces.push_back(type);
+                continue;
+            case category::class_type:
+                if (extends_type(type, "System"sv, "Attribute"sv))
+                {
+                    m_categories.attributes.push_back(type);
+                    continue;
+                }
+                m_categories.classes.push_back(type);
+                continue;
+            case category::enum_type:
+                m_categories.enums.push_back(type);
+                continue;
+            case category::struct_type:
+                if (get_attribute(type, api_contract_attribute))
+                {
+                    m_categories.contracts.push_back(type);
+                    continue;
+                }
+                m_categories.structs.push_back(type);
+                continue;
+            case category::delegate_type:
+                m_categories.delegates.push_back(type);
+                continue;
+            }
+        }
+    }
+
+    inline TypeDef database::resolve(reader::TypeRef const& type) const
+    {
+        auto const& cache = get_cache();
+        auto& slot = m_type_refs[type.index()];
+        auto resolved = slot.load(std::memory_order_relaxed);
+
+        if (!resolved)
+        {
+            // Concurrent readers may race to fill the same slot, but they always store the same value.
+            auto const entry = cache.find_entry(type.TypeNamespace(), type.TypeName());
+            resolved = entry ? static_cast<uint32_t>(entry - cache.m_type_index.begin()) + 1 : unresolved_type;
+            slot.store(resolved, std::memory_order_relaxed);
+        }
+
+        if (resolved == unresolved_type)
+        {
+            return {};
+        }
+
+        return cache.get_type(cache.m_type_index.begin()[resolved - 1]);
+    }
+}
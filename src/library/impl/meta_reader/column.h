@@ -40,7 +40,14 @@ namespace xlang::meta::reader
             }
         };
         auto const& map = get_database().template get_table<T>();
-        return std::upper_bound(map.begin(), map.end(), index() + 1, compare{}) - 1;
+        auto const parent = std::upper_bound(map.begin(), map.end(), index() + 1, compare{});
+
+        if (parent == map.begin())
+        {
+            throw_invalid("Invalid row index");
+        }
+
+        return parent - 1;
     }
 
     inline auto TypeDef::GenericParam() const
@@ -53,6 +60,24 @@ namespace xlang::meta::reader
         return equal_range(get_database().GenericParam, coded_index<TypeOrMethodDef>());
     }
 
+    inline auto GenericParam::GenericParamConstraint() const
+    {
+        struct compare
+        {
+            bool operator()(uint32_t const left, reader::GenericParamConstraint const& right) noexcept
+            {
+                return left < right.get_value<uint32_t>(0);
+            }
+
+            bool operator()(reader::GenericParamConstraint const& left, uint32_t const right) noexcept
+            {
+                return left.get_value<uint32_t>(0) < right;
+            }
+        };
+
+        return equal_range(get_database().GenericParamConstraint, index() + 1, compare{});
+    }
+
     inline auto TypeDef::InterfaceImpl() const
     {
         struct compare
@@ -81,6 +106,26 @@ namespace xlang::meta::reader
         return get_list<MethodDef>(5);
     }
 
+    inline MethodDefSig MethodDef::Signature() const
+    {
+        return get_database().get_signature<MethodDefSig>(get_table(), get_value<uint32_t>(4));
+    }
+
+    inline MethodDefSig MemberRef::MethodSignature() const
+    {
+        return get_database().get_signature<MethodDefSig>(get_table(), get_value<uint32_t>(2));
+    }
+
+    inline FieldSig Field::Signature() const
+    {
+        return get_database().get_signature<FieldSig>(get_table(), get_value<uint32_t>(2));
+    }
+
+    inline TypeSpecSig TypeSpec::Signature() const
+    {
+        return get_database().get_signature<TypeSpecSig>(get_table(), get_value<uint32_t>(0));
+    }
+
     inline auto MethodDef::ParamList() const
     {
         return get_list<Param>(5);
@@ -148,39 +193,29 @@ namespace xlang::meta::reader
 
     inline auto TypeDef::PropertyList() const
     {
-        auto const& map = get_database().get_table<PropertyMap>();
-        auto index = this->index() + 1;
-        auto iter = std::find_if(map.begin(), map.end(), [index](PropertyMap const& elem)
-        {
-            return elem.get_value<uint32_t>(0) == index;
-        });
-        if (iter == map.end())
+        auto const map = get_database().find_property_map(*this);
+        if (!map)
         {
             auto const& props = get_database().get_table<Property>();
             return std::pair{ props.end(), props.end() };
         }
         else
         {
-            return iter.PropertyList();
+            return map.PropertyList();
         }
     }
 
     inline auto TypeDef::EventList() const
     {
-        auto const& map = get_database().get_table<EventMap>();
-        auto index = this->index() + 1;
-        auto iter = std::find_if(map.begin(), map.end(), [index](EventMap const& elem)
+        auto const map = get_database().find_event_map(*this);
+        if (!map)
         {
-            return elem.get_value<uint32_t>(0) == index;
-        });
-        if (iter == map.end())
-        {
-            auto const& props = get_database().get_table<Event>();
-            return std::pair{ props.end(), props.end() };
+            auto const& events = get_database().get_table<Event>();
+            return std::pair{ events.end(), events.end() };
         }
         else
         {
-            return iter.EventList();
+            return map.EventList();
         }
     }
 
@@ -30,6 +30,61 @@ namespace xlang::meta::reader
         }
     }
 
+    inline void database::index_attributes() const
+    {
+        std::call_once(m_attribute_once, [&]
+        {
+            m_attributes.reset(m_attributes.get_capacity(CustomAttribute.size()));
+
+            // Rows are visited in table order so the first attribute of each type wins, matching a
+            // linear walk of the parent's attribute range.
+            for (auto&& attribute : CustomAttribute)
+            {
+                auto const[type_namespace, type_name] = attribute.TypeNamespaceAndName();
+                attribute_entry const entry{ make_attribute_parent(attribute.Parent()), impl::hash_type_name(type_namespace, type_name), attribute.index() + 1 };
+
+                m_attributes.insert(hash_attribute(entry.parent, entry.type), entry, [&](attribute_entry const& other)
+                {
+                    return other.parent == entry.parent && other.type == entry.type;
+                });
+            }
+        });
+    }
+
+    inline CustomAttribute database::find_attribute(coded_index<HasCustomAttribute> const& parent, attribute_type const& type) const
+    {
+        index_attributes();
+        auto const key = make_attribute_parent(parent);
+
+        auto const found = m_attributes.find(hash_attribute(key, type.hash), [&](attribute_entry const& entry)
+        {
+            return entry.parent == key && entry.type == type.hash;
+        });
+
+        if (!found)
+        {
+            return {};
+        }
+
+        auto const attribute = CustomAttribute[found->row - 1];
+
+        if (attribute.TypeNamespaceAndName() == std::pair{ type.type_namespace, type.type_name })
+        {
+            return attribute;
+        }
+
+        // Different attribute types with the same hash on one row; fall back to a linear walk.
+        for (auto&& candidate : equal_range(CustomAttribute, parent))
+        {
+            if (candidate.TypeNamespaceAndName() == std::pair{ type.type_namespace, type.type_name })
+            {
+                return candidate;
+            }
+        }
+
+        return {};
+    }
+
     struct ElemSig
     {
         struct SystemType
@@ -19,12 +19,205 @@ namespace xlang::impl
     static_assert(bits_needed(4) == 2);
     static_assert(bits_needed(5) == 3);
     static_assert(bits_needed(22) == 5);
+
+    // FNV-1a over "<namespace>.<name>", so a full type name hashes the same as its parts.
+    constexpr uint64_t hash_type_name(std::string_view const& type_namespace, std::string_view const& type_name) noexcept
+    {
+        uint64_t hash{ 14695981039346656037ull };
+
+        for (auto&& value : type_namespace)
+        {
+            hash = (hash ^ static_cast<uint8_t>(value)) * 1099511628211ull;
+        }
+
+        hash = (hash ^ static_cast<uint8_t>('.')) * 1099511628211ull;
+
+        for (auto&& value : type_name)
+        {
+            hash = (hash ^ static_cast<uint8_t>(value)) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // An open-addressing table of trivially copyable entries with a power of two capacity, whose
+    // entries are either owned or borrowed from a mapped cache snapshot so that lookups can probe
+    // the snapshot in place. A default-constructed entry marks an empty slot.
+    template <typename Entry>
+    struct probe_table
+    {
+        static_assert(std::is_trivially_copyable_v<Entry>);
+
+        // Keeps the load factor at or below one half so that probe sequences stay short.
+        static std::size_t get_capacity(std::size_t const count) noexcept
+        {
+            std::size_t capacity{ 16 };
+
+            while (capacity < count * 2)
+            {
+                capacity *= 2;
+            }
+
+            return capacity;
+        }
+
+        void reset(std::size_t const capacity)
+        {
+            XLANG_ASSERT((capacity & (capacity - 1)) == 0);
+            m_storage.assign(capacity, Entry{});
+            m_entries = m_storage.data();
+            m_capacity = capacity;
+        }
+
+        void borrow(Entry const* const entries, std::size_t const capacity) noexcept
+        {
+            XLANG_ASSERT((capacity & (capacity - 1)) == 0);
+            m_storage.clear();
+            m_entries = entries;
+            m_capacity = capacity;
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        Entry const* begin() const noexcept
+        {
+            return m_entries;
+        }
+
+        Entry const* end() const noexcept
+        {
+            return m_entries + m_capacity;
+        }
+
+        // Returns the first entry along the probe sequence of hash that matches, or nullptr.
+        template <typename Match>
+        Entry const* find(uint64_t const hash, Match&& match) const
+        {
+            if (!m_capacity)
+            {
+                return nullptr;
+            }
+
+            auto const mask = m_capacity - 1;
+
+            for (auto slot = hash & mask; m_entries[slot]; slot = (slot + 1) & mask)
+            {
+                if (match(m_entries[slot]))
+                {
+                    return m_entries + slot;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // Stores entry in the first empty slot along the probe sequence of hash, unless an entry
+        // that matches is found first. Only owned tables can be inserted into.
+        template <typename Match>
+        void insert(uint64_t const hash, Entry const& entry, Match&& match)
+        {
+            XLANG_ASSERT(m_entries == m_storage.data());
+            auto const mask = m_capacity - 1;
+            auto slot = hash & mask;
+
+            for (; m_storage[slot]; slot = (slot + 1) & mask)
+            {
+                if (match(m_storage[slot]))
+                {
+                    return;
+                }
+            }
+
+            m_storage[slot] = entry;
+        }
+
+    private:
+
+        std::vector<Entry> m_storage;
+        Entry const* m_entries{};
+        std::size_t m_capacity{};
+    };
 }
 
 namespace xlang::meta::reader
 {
     struct cache;
 
+    // Identifies a custom attribute by type name, with the hash used by the database attribute
+    // index computed up front so that well-known attribute types can be declared constexpr.
+    struct attribute_type
+    {
+        constexpr attribute_type(std::string_view const& type_namespace, std::string_view const& type_name) noexcept :
+            type_namespace{ type_namespace },
+            type_name{ type_name },
+            hash{ impl::hash_type_name(type_namespace, type_name) }
+        {
+        }
+
+        std::string_view type_namespace;
+        std::string_view type_name;
+        uint64_t hash;
+    };
+
+    // Decoded signatures keyed by #Blob offset. Readers share the lock; a miss is decoded outside of
+    // the lock and the first inserted result wins, so concurrent decoders of the same blob agree.
+    template <typename Signature>
+    struct signature_map
+    {
+        template <typename Parse>
+        Signature const& get(uint32_t const index, Parse&& parse)
+        {
+            {
+                std::shared_lock lock{ m_mutex };
+                auto found = m_signatures.find(index);
+
+                if (found != m_signatures.end())
+                {
+                    return found->second;
+                }
+            }
+
+            auto signature = parse();
+            std::unique_lock lock{ m_mutex };
+            return m_signatures.try_emplace(index, std::move(signature)).first->second;
+        }
+
+    private:
+
+        std::shared_mutex m_mutex;
+        std::unordered_map<uint32_t, Signature> m_signatures;
+    };
+
+    struct signature_cache
+    {
+        template <typename Signature>
+        auto& get() noexcept
+        {
+            if constexpr (std::is_same_v<Signature, MethodDefSig>)
+            {
+                return m_methods;
+            }
+            else if constexpr (std::is_same_v<Signature, FieldSig>)
+            {
+                return m_fields;
+            }
+            else
+            {
+                static_assert(std::is_same_v<Signature, TypeSpecSig>);
+                return m_type_specs;
+            }
+        }
+
+    private:
+
+        signature_map<MethodDefSig> m_methods;
+        signature_map<FieldSig> m_fields;
+        signature_map<TypeSpecSig> m_type_specs;
+    };
+
     struct database
     {
         database(database&&) = delete;
@@ -32,8 +225,11 @@ namespace xlang::meta::reader
 
         static bool is_database(std::string_view const& path)
         {
-            file_view file{ path };
+            return is_database_image(file_view{ path });
+        }
 
+        static bool is_database_image(byte_view const& file)
+        {
             if (file.size() < sizeof(impl::image_dos_header))
             {
                 return false;
@@ -114,7 +310,15 @@ namespace xlang::meta::reader
             initialize();
         }
 
-        explicit database(std::string_view const& path, cache const* cache = nullptr) : m_view{ path }, m_path{ path }, m_cache{ cache }
+        explicit database(std::string_view const& path, cache const* cache = nullptr, file_view_options const& options = {}) : m_view{ path, options }, m_path{ path }, m_cache{ cache }
+        {
+            initialize(options.advise);
+        }
+
+        // Reads a database from memory owned by the caller, such as a winmd packed inside a larger
+        // archive or embedded as a resource. The memory must outlive the database and anything read
+        // from it. The name is reported by path() and need not refer to a file.
+        database(byte_view const& image, std::string_view const& name, cache const* cache = nullptr) : m_view{ image.begin(), image.end() }, m_path{ name }, m_cache{ cache }
         {
             initialize();
         }
@@ -184,6 +388,64 @@ namespace xlang::meta::reader
             return { reinterpret_cast<char const*>(view.begin()), static_cast<uint32_t>(last - view.begin()) };
         }
 
+        byte_view get_guid(uint32_t const index) const
+        {
+            if (!index)
+            {
+                throw_invalid("Invalid GUID index");
+            }
+
+            return m_guids.sub((index - 1) * 16, 16);
+        }
+
+        // Opts in to keeping every decoded method, field and type spec signature for the lifetime
+        // of the database, so repeated Signature() calls copy the decoded form instead of
+        // re-parsing the blob. Must be called before the database is shared between threads.
+        void enable_signature_cache()
+        {
+            if (!m_signatures)
+            {
+                m_signatures = std::make_unique<signature_cache>();
+            }
+        }
+
+        template <typename Signature>
+        Signature get_signature(table_base const* const table, uint32_t const index) const
+        {
+            auto parse = [&]
+            {
+                auto cursor = get_blob(index);
+                return Signature{ table, cursor };
+            };
+
+            if (!m_signatures)
+            {
+                return parse();
+            }
+
+            return m_signatures->get<Signature>().get(index, parse);
+        }
+
+        // Returns the first attribute of the given type applied to parent, or an empty row if there is
+        // none. The first call indexes every CustomAttribute row by parent and attribute type.
+        reader::CustomAttribute find_attribute(coded_index<HasCustomAttribute> const& parent, attribute_type const& type) const;
+
+        // Resolves a TypeRef to its definition through the cache, memoizing the result per TypeRef row.
+        // Returns an empty TypeDef if the type is not defined by any database in the cache.
+        reader::TypeDef resolve(reader::TypeRef const& type) const;
+
+        reader::PropertyMap find_property_map(reader::TypeDef const& type) const
+        {
+            std::call_once(m_property_map_once, [&] { index_parent_rows(PropertyMap, m_property_map_index); });
+            return find_parent_row(PropertyMap, m_property_map_index, type);
+        }
+
+        reader::EventMap find_event_map(reader::TypeDef const& type) const
+        {
+            std::call_once(m_event_map_once, [&] { index_parent_rows(EventMap, m_event_map_index); });
+            return find_parent_row(EventMap, m_event_map_index, type);
+        }
+
         byte_view get_blob(uint32_t const index) const
         {
             auto view = m_blobs.seek(index);
@@ -226,7 +488,7 @@ namespace xlang::meta::reader
         }
 
     private:
-        void initialize()
+        void initialize(bool const advise = false)
         {
             auto dos = m_view.as<impl::image_dos_header>();
 
@@ -290,6 +552,7 @@ namespace xlang::meta::reader
                 throw_invalid("CLI metadata magic signature not found");
             }
 
+            auto const metadata = m_view.seek(offset);
             auto version_length = m_view.as<uint32_t>(offset + 12);
             auto stream_count = m_view.as<uint16_t>(offset + version_length + 18);
             auto view = m_view.seek(offset + version_length + 20);
@@ -324,6 +587,31 @@ namespace xlang::meta::reader
                 view = view.seek(stream_offset(name.data()));
             }
 
+            m_stream_headers = { metadata.begin(), view.begin() };
+
+            // Columns are read eight bytes at a time, so the table stream must be followed by enough
+            // readable bytes. This is almost always the case, but otherwise read from a padded copy.
+            if (tables && m_view.end() - tables.end() < 8)
+            {
+                m_tables.assign(tables.begin(), tables.end());
+                m_tables.resize(m_tables.size() + 8);
+                tables = { m_tables.data(), m_tables.data() + tables.size() };
+            }
+
+            // Tables are walked in no particular order and nearly all of them are read, while only
+            // the heap entries that are referenced are read. A padded copy of the tables is not
+            // part of the view, so there is nothing to advise.
+            if (advise)
+            {
+                if (m_tables.empty())
+                {
+                    m_view.advise(tables, file_advice::will_need);
+                }
+
+                m_view.advise(m_strings, file_advice::random);
+                m_view.advise(m_blobs, file_advice::random);
+            }
+
             std::bitset<8> const heap_sizes{ tables.as<uint8_t>(6) };
             uint8_t const string_index_size = heap_sizes.test(0) ? 4 : 2;
             uint8_t const guid_index_size = heap_sizes.test(1) ? 4 : 2;
@@ -386,11 +674,13 @@ namespace xlang::meta::reader
                 };
             }
 
+            m_table_header = { tables.begin(), view.begin() };
+
             table_base const empty_table{ nullptr };
 
             auto const TypeDefOrRef = composite_index_size(TypeDef, TypeRef, TypeSpec);
             auto const HasConstant = composite_index_size(Field, Param, Property);
-            auto const HasCustomAttribute = composite_index_size(MethodDef, Field, TypeRef, TypeDef, Param, InterfaceImpl, MemberRef, Module, Property, Event, StandAloneSig, ModuleRef, TypeSpec, Assembly, AssemblyRef, File, ExportedType, ManifestResource, GenericParam, GenericParamConstraint, MethodSpec);
+            auto const HasCustomAttribute = composite_index_size(MethodDef, Field, TypeRef, TypeDef, Param, InterfaceImpl, MemberRef, Module, DeclSecurity, Property, Event, StandAloneSig, ModuleRef, TypeSpec, Assembly, AssemblyRef, File, ExportedType, ManifestResource, GenericParam, GenericParamConstraint, MethodSpec);
             auto const HasFieldMarshal = composite_index_size(Field, Param);
             auto const HasDeclSecurity = composite_index_size(TypeDef, MethodDef, Assembly);
             auto const MemberRefParent = composite_index_size(TypeDef, TypeRef, ModuleRef, MethodDef, TypeSpec);
@@ -479,6 +769,108 @@ namespace xlang::meta::reader
             GenericParam.set_data(view);
             MethodSpec.set_data(view);
             GenericParamConstraint.set_data(view);
+
+            validate_indexes();
+
+            m_type_refs = std::make_unique<std::atomic<uint32_t>[]>(TypeRef.size());
+        }
+
+        // Checks every table and coded index column once, so that rows reached through them are in
+        // range and table_base::get_value does not need to check bounds on each read.
+        void validate_indexes() const
+        {
+            validate_list(TypeDef, 4, Field);
+            validate_list(TypeDef, 5, MethodDef);
+            validate_list(MethodDef, 5, Param);
+            validate_list(PropertyMap, 1, Property);
+            validate_list(EventMap, 1, Event);
+
+            validate_index(InterfaceImpl, 0, TypeDef);
+            validate_index(PropertyMap, 0, TypeDef);
+            validate_index(EventMap, 0, TypeDef);
+            validate_index(MethodSemantics, 1, MethodDef);
+            validate_index(MethodImpl, 0, TypeDef);
+            validate_index(NestedClass, 0, TypeDef);
+            validate_index(NestedClass, 1, TypeDef);
+            validate_index(ClassLayout, 2, TypeDef);
+            validate_index(FieldLayout, 1, Field);
+            validate_index(FieldRVA, 1, Field);
+            validate_index(GenericParamConstraint, 0, GenericParam);
+            validate_index(ImplMap, 3, ModuleRef);
+            validate_index(AssemblyRefOS, 3, AssemblyRef);
+            validate_index(AssemblyRefProcessor, 1, AssemblyRef);
+
+            validate_coded_index<ResolutionScope>(TypeRef, 0, { &Module, &ModuleRef, &AssemblyRef, &TypeRef });
+            validate_coded_index<TypeDefOrRef>(TypeDef, 3, { &TypeDef, &TypeRef, &TypeSpec });
+            validate_coded_index<TypeDefOrRef>(InterfaceImpl, 1, { &TypeDef, &TypeRef, &TypeSpec });
+            validate_coded_index<TypeDefOrRef>(Event, 2, { &TypeDef, &TypeRef, &TypeSpec });
+            validate_coded_index<TypeDefOrRef>(GenericParamConstraint, 1, { &TypeDef, &TypeRef, &TypeSpec });
+            validate_coded_index<MemberRefParent>(MemberRef, 0, { &TypeDef, &TypeRef, &ModuleRef, &MethodDef, &TypeSpec });
+            validate_coded_index<HasConstant>(Constant, 1, { &Field, &Param, &Property });
+            validate_coded_index<HasCustomAttribute>(CustomAttribute, 0, { &MethodDef, &Field, &TypeRef, &TypeDef, &Param, &InterfaceImpl, &MemberRef, &Module, &DeclSecurity, &Property, &Event, &StandAloneSig, &ModuleRef, &TypeSpec, &Assembly, &AssemblyRef, &File, &ExportedType, &ManifestResource, &GenericParam, &GenericParamConstraint, &MethodSpec });
+            validate_coded_index<CustomAttributeType>(CustomAttribute, 1, { nullptr, nullptr, &MethodDef, &MemberRef });
+            validate_coded_index<HasFieldMarshal>(FieldMarshal, 0, { &Field, &Param });
+            validate_coded_index<HasDeclSecurity>(DeclSecurity, 1, { &TypeDef, &MethodDef, &Assembly });
+            validate_coded_index<HasSemantics>(MethodSemantics, 2, { &Event, &Property });
+            validate_coded_index<MethodDefOrRef>(MethodImpl, 1, { &MethodDef, &MemberRef });
+            validate_coded_index<MethodDefOrRef>(MethodImpl, 2, { &MethodDef, &MemberRef });
+            validate_coded_index<MethodDefOrRef>(MethodSpec, 0, { &MethodDef, &MemberRef });
+            validate_coded_index<MemberForwarded>(ImplMap, 1, { &Field, &MethodDef });
+            validate_coded_index<Implementation>(ExportedType, 4, { &File, &AssemblyRef, &ExportedType });
+            validate_coded_index<Implementation>(ManifestResource, 3, { &File, &AssemblyRef, &ExportedType });
+            validate_coded_index<TypeOrMethodDef>(GenericParam, 2, { &TypeDef, &MethodDef });
+        }
+
+        static void validate_index(table_base const& source, uint32_t const column, table_base const& target)
+        {
+            for (uint32_t row{}; row < source.size(); ++row)
+            {
+                auto const value = source.get_value<uint32_t>(row, column);
+
+                if (value == 0 || value > target.size())
+                {
+                    throw_invalid("Invalid table index");
+                }
+            }
+        }
+
+        static void validate_list(table_base const& source, uint32_t const column, table_base const& target)
+        {
+            uint32_t previous{ 1 };
+
+            for (uint32_t row{}; row < source.size(); ++row)
+            {
+                auto const value = source.get_value<uint32_t>(row, column);
+
+                if (value < previous || value > target.size() + 1)
+                {
+                    throw_invalid("Invalid table list");
+                }
+
+                previous = value;
+            }
+        }
+
+        template <typename T>
+        static void validate_coded_index(table_base const& source, uint32_t const column, std::initializer_list<table_base const*> const targets)
+        {
+            for (uint32_t row{}; row < source.size(); ++row)
+            {
+                auto const value = source.get_value<uint32_t>(row, column);
+                auto const target_row = value >> coded_index_bits_v<T>;
+
+                if (target_row == 0)
+                {
+                    continue;
+                }
+
+                auto const tag = value & ((1 << coded_index_bits_v<T>) - 1);
+
+                if (tag >= targets.size() || !targets.begin()[tag] || target_row > targets.begin()[tag]->size())
+                {
+                    throw_invalid("Invalid coded index");
+                }
+            }
         }
 
         struct stream_range
@@ -510,6 +902,73 @@ namespace xlang::meta::reader
             return static_cast<uint32_t>(8 + name.size() + padding);
         }
 
+        // Maps each TypeDef row to one past the index of the map row (PropertyMap or EventMap) whose
+        // Parent column refers to it, leaving zero for types without a map row.
+        template <typename Row>
+        void index_parent_rows(table<Row> const& map, std::vector<uint32_t>& index) const
+        {
+            index.resize(TypeDef.size());
+
+            for (auto&& row : map)
+            {
+                auto const parent = row.template get_value<uint32_t>(0);
+
+                if (parent == 0 || parent > index.size())
+                {
+                    throw_invalid("Invalid map parent index");
+                }
+
+                if (!index[parent - 1])
+                {
+                    index[parent - 1] = row.index() + 1;
+                }
+            }
+        }
+
+        template <typename Row>
+        static Row find_parent_row(table<Row> const& map, std::vector<uint32_t> const& index, reader::TypeDef const& type) noexcept
+        {
+            if (type.index() >= index.size() || !index[type.index()])
+            {
+                return {};
+            }
+
+            return map[index[type.index()] - 1];
+        }
+
+        friend cache;
+
+        // m_type_refs holds the type index slot of each resolved TypeRef plus one, zero if it was
+        // not yet resolved, or unresolved_type if no database in the cache defines it.
+        static constexpr uint32_t unresolved_type{ 0xffffffff };
+
+        void index_attributes() const;
+
+        // Parent and type are the coded index of the parent row and the hash of the attribute type
+        // name, and row is the CustomAttribute row plus one, or zero for an empty slot.
+        struct attribute_entry
+        {
+            uint64_t parent;
+            uint64_t type;
+            uint32_t row;
+            uint32_t reserved;
+
+            explicit operator bool() const noexcept
+            {
+                return row != 0;
+            }
+        };
+
+        static uint64_t make_attribute_parent(coded_index<HasCustomAttribute> const& parent) noexcept
+        {
+            return (static_cast<uint64_t>(parent.index()) << 8) | static_cast<uint64_t>(parent.type());
+        }
+
+        static uint64_t hash_attribute(uint64_t const parent, uint64_t const type) noexcept
+        {
+            return type ^ (parent * 0x9e3779b97f4a7c15ull);
+        }
+
         static impl::image_section_header const* section_from_rva(impl::image_section_header const* const first, impl::image_section_header const* const last, uint32_t const rva) noexcept
         {
             return std::find_if(first, last, [rva](auto&& section) noexcept
@@ -525,12 +984,24 @@ namespace xlang::meta::reader
 
         std::vector<uint8_t> m_buffer;
         file_view m_view;
+        std::vector<uint8_t> m_tables;
 
         std::string const m_path;
         byte_view m_strings;
         byte_view m_blobs;
         byte_view m_guids;
+        byte_view m_stream_headers;
+        byte_view m_table_header;
         cache const* m_cache;
+
+        mutable std::once_flag m_property_map_once;
+        mutable std::once_flag m_event_map_once;
+        mutable std::vector<uint32_t> m_property_map_index;
+        mutable std::vector<uint32_t> m_event_map_index;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_type_refs;
+        std::unique_ptr<signature_cache> m_signatures;
+        mutable std::once_flag m_attribute_once;
+        mutable impl::probe_table<attribute_entry> m_attributes;
     };
 
     template <typename Row>
@@ -10,19 +10,13 @@ namespace xlang::meta::reader
         {
             for (auto&& include : includes)
             {
-                m_rules.push_back({ include, true });
+                add(include, true);
             }
 
             for (auto&& exclude : excludes)
             {
-                m_rules.push_back({ exclude, false });
+                add(exclude, false);
             }
-
-            std::sort(m_rules.begin(), m_rules.end(), [](auto const& lhs, auto const& rhs)
-            {
-                auto size_compare = int(lhs.first.size()) - int(rhs.first.size());
-                return (size_compare > 0) || ((size_compare == 0) && !lhs.second);
-            });
         }
 
         bool includes(TypeDef const& type) const
@@ -38,7 +32,7 @@ namespace xlang::meta::reader
 
         bool includes(std::vector<TypeDef> const& types) const
         {
-            if (m_rules.empty())
+            if (m_nodes.empty())
             {
                 return true;
             }
@@ -54,16 +48,35 @@ namespace xlang::meta::reader
             return false;
         }
 
+        // The rules are resolved once for the namespace, and the type names are only looked at if
+        // some rule is longer than the namespace itself.
         bool includes(cache::namespace_members const& members) const
         {
-            if (m_rules.empty())
+            if (m_nodes.empty())
             {
                 return true;
             }
 
+            if (members.types.empty())
+            {
+                return false;
+            }
+
+            auto position = start();
+            advance(position, members.types.begin()->second.TypeNamespace());
+            advance(position, "."sv);
+
+            if (!position.found || m_nodes[position.node].children.empty())
+            {
+                return position.result;
+            }
+
             for (auto&& type : members.types)
             {
-                if (includes(type.second.TypeNamespace(), type.second.TypeName()))
+                auto type_position = position;
+                advance(type_position, type.second.TypeName());
+
+                if (type_position.result)
                 {
                     return true;
                 }
@@ -89,49 +102,106 @@ namespace xlang::meta::reader
 
         bool empty() const noexcept
         {
-            return m_rules.empty();
+            return m_nodes.empty();
         }
 
     private:
 
-        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        // The rules form a trie keyed by character, since a rule is a plain prefix of the full type
+        // name and need not end on a namespace boundary. Walking a name through the trie finds the
+        // longest matching rule, with excludes winning over includes of the same length.
+        struct node
+        {
+            std::vector<std::pair<char, uint32_t>> children;
+            std::optional<bool> rule;
+        };
+
+        struct cursor
+        {
+            uint32_t node{};
+            bool found{ true };
+            bool result{};
+        };
+
+        void add(std::string_view const& match, bool const include)
         {
-            if (m_rules.empty())
+            if (m_nodes.empty())
             {
-                return true;
+                m_nodes.emplace_back();
             }
 
-            for (auto&& rule : m_rules)
+            uint32_t current{};
+
+            for (auto c : match)
             {
-                if (match(type_namespace, type_name, rule.first))
+                auto const next = find(current, c);
+
+                if (next)
                 {
-                    return rule.second;
+                    current = next;
+                    continue;
                 }
+
+                m_nodes[current].children.emplace_back(c, static_cast<uint32_t>(m_nodes.size()));
+                current = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
             }
 
-            return false;
+            auto& rule = m_nodes[current].rule;
+            rule = rule.value_or(true) && include;
         }
 
-        static bool match(std::string_view const& type_namespace, std::string_view const& type_name, std::string_view const& match) noexcept
+        uint32_t find(uint32_t const current, char const c) const noexcept
         {
-            if (match.size() <= type_namespace.size())
+            for (auto&& [value, index] : m_nodes[current].children)
             {
-                return starts_with(type_namespace, match);
+                if (value == c)
+                {
+                    return index;
+                }
             }
 
-            if (!starts_with(match, type_namespace))
+            return 0;
+        }
+
+        cursor start() const noexcept
+        {
+            return { 0, true, m_nodes[0].rule.value_or(false) };
+        }
+
+        void advance(cursor& position, std::string_view const& value) const noexcept
+        {
+            for (auto c : value)
             {
-                return false;
+                if (!position.found)
+                {
+                    return;
+                }
+
+                position.node = find(position.node, c);
+                position.found = position.node != 0;
+
+                if (position.found && m_nodes[position.node].rule)
+                {
+                    position.result = *m_nodes[position.node].rule;
+                }
             }
+        }
 
-            if (match[type_namespace.size()] != '.')
+        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            if (m_nodes.empty())
             {
-                return false;
+                return true;
             }
 
-            return starts_with(type_name, match.substr(type_namespace.size() + 1));
+            auto position = start();
+            advance(position, type_namespace);
+            advance(position, "."sv);
+            advance(position, type_name);
+            return position.result;
         }
 
-        std::vector<std::pair<std::string, bool>> m_rules;
+        std::vector<node> m_nodes;
     };
 }
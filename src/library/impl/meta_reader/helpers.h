@@ -15,12 +15,19 @@ namespace xlang::meta::reader
 
     inline auto find(TypeRef const& type)
     {
-        return type.get_database().get_cache().find(type.TypeNamespace(), type.TypeName());
+        return type.get_database().resolve(type);
     }
 
     inline auto find_required(TypeRef const& type)
     {
-        return type.get_database().get_cache().find_required(type.TypeNamespace(), type.TypeName());
+        auto definition = type.get_database().resolve(type);
+
+        if (!definition)
+        {
+            throw_invalid("Type '", type.TypeNamespace(), ".", type.TypeName(), "' could not be found");
+        }
+
+        return definition;
     }
 
     inline TypeDef find_required(coded_index<TypeDefOrRef> const& type)
@@ -69,4 +76,47 @@ namespace xlang::meta::reader
 
         return false;
     };
+
+    // A rough measure of how much code a namespace projects, dominated by its members, so that
+    // parallel generation can start the longest namespaces first. Only the types map is read, so
+    // that namespaces of a deferred cache are not categorized just to be measured.
+    inline std::size_t estimate_size(cache::namespace_members const& members)
+    {
+        std::size_t result{};
+
+        for (auto&&[name, type] : members.types)
+        {
+            result += 1 + size(type.MethodList()) + size(type.FieldList()) + size(type.PropertyList()) + size(type.EventList());
+        }
+
+        return result;
+    }
+
+    // Returns the cache's namespaces from the largest estimated size to the smallest.
+    inline auto get_namespaces_by_size(cache const& c)
+    {
+        using namespace_entry = std::remove_reference_t<cache::namespace_type>;
+        std::vector<std::pair<std::size_t, namespace_entry*>> sized;
+        sized.reserve(c.namespaces().size());
+
+        for (auto&& entry : c.namespaces())
+        {
+            sized.emplace_back(estimate_size(entry.second), &entry);
+        }
+
+        std::stable_sort(sized.begin(), sized.end(), [](auto&& left, auto&& right)
+        {
+            return left.first > right.first;
+        });
+
+        std::vector<namespace_entry*> result;
+        result.reserve(sized.size());
+
+        for (auto&& [estimate, entry] : sized)
+        {
+            result.push_back(entry);
+        }
+
+        return result;
+    }
 }
@@ -6,7 +6,15 @@ namespace xlang::meta::reader
     Row index_base<T>::get_row() const
     {
         XLANG_ASSERT(type() == (index_tag_v<T, Row>));
-        return get_database().template get_table<Row>()[index()];
+        auto const& table = get_database().template get_table<Row>();
+
+        // Coded indexes are range checked at load, leaving only the null index to reject here.
+        if (index() >= table.size())
+        {
+            throw_invalid("Invalid row index");
+        }
+
+        return table[index()];
     }
 
     inline auto typed_index<CustomAttributeType>::MemberRef() const
@@ -159,19 +167,22 @@ namespace xlang::meta::reader
         return EnumDefinition{ *this };
     }
 
+    inline constexpr attribute_type activatable_attribute{ "Windows.Foundation.Metadata"sv, "ActivatableAttribute"sv };
+    inline constexpr attribute_type api_contract_attribute{ "Windows.Foundation.Metadata"sv, "ApiContractAttribute"sv };
+    inline constexpr attribute_type contract_version_attribute{ "Windows.Foundation.Metadata"sv, "ContractVersionAttribute"sv };
+    inline constexpr attribute_type default_attribute{ "Windows.Foundation.Metadata"sv, "DefaultAttribute"sv };
+    inline constexpr attribute_type exclusive_to_attribute{ "Windows.Foundation.Metadata"sv, "ExclusiveToAttribute"sv };
+    inline constexpr attribute_type guid_attribute{ "Windows.Foundation.Metadata"sv, "GuidAttribute"sv };
+
     template <typename T>
-    CustomAttribute get_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
+    CustomAttribute get_attribute(T const& row, attribute_type const& type)
     {
-        for (auto&& attribute : row.CustomAttribute())
-        {
-            auto pair = attribute.TypeNamespaceAndName();
-
-            if (pair.first == type_namespace && pair.second == type_name)
-            {
-                return attribute;
-            }
-        }
+        return row.get_database().find_attribute(row.template coded_index<HasCustomAttribute>(), type);
+    }
 
-        return {};
+    template <typename T>
+    CustomAttribute get_attribute(T const& row, std::string_view const& type_namespace, std::string_view const& type_name)
+    {
+        return get_attribute(row, attribute_type{ type_namespace, type_name });
     }
 }
@@ -104,11 +104,7 @@ namespace xlang::meta::reader
             return get_string(3);
         }
 
-        MethodDefSig Signature() const
-        {
-            auto cursor = get_blob(4);
-            return{ get_table(), cursor };
-        }
+        MethodDefSig Signature() const;
 
         auto ParamList() const;
         auto CustomAttribute() const;
@@ -135,11 +131,7 @@ namespace xlang::meta::reader
             return get_string(1);
         }
 
-        MethodDefSig MethodSignature() const
-        {
-            auto cursor = get_blob(2);
-            return{ get_table(), cursor };
-        }
+        MethodDefSig MethodSignature() const;
 
         auto CustomAttribute() const;
     };
@@ -170,11 +162,7 @@ namespace xlang::meta::reader
             return get_string(1);
         }
 
-        auto Signature() const
-        {
-            auto cursor = get_blob(2);
-            return FieldSig{ get_table(), cursor };
-        }
+        FieldSig Signature() const;
 
         auto CustomAttribute() const;
         auto Constant() const;
@@ -261,11 +249,7 @@ namespace xlang::meta::reader
     {
         using row_base::row_base;
 
-        TypeSpecSig Signature() const
-        {
-            auto cursor = get_blob(0);
-            return{ get_table(), cursor };
-        }
+        TypeSpecSig Signature() const;
 
         auto CustomAttribute() const;
     };
@@ -603,6 +587,7 @@ namespace xlang::meta::reader
             return get_string(3);
         }
 
+        auto GenericParamConstraint() const;
         auto CustomAttribute() const;
     };
 
@@ -617,6 +602,11 @@ namespace xlang::meta::reader
     {
         using row_base::row_base;
 
+        auto Constraint() const
+        {
+            return get_coded_index<TypeDefOrRef>(1);
+        }
+
         auto CustomAttribute() const;
     };
 
@@ -1,6 +1,175 @@
 
+namespace xlang::impl
+{
+    // Recycles the storage of signature vectors through per-thread free lists bucketed by
+    // power-of-two size. Generators parse the same kinds of signatures over and over, so once the
+    // lists are warm, parsing no longer reaches the heap. Each list is capped so that blocks freed
+    // on a different thread than the one that allocated them cannot pile up without bound.
+    struct signature_pool
+    {
+        static void* allocate(std::size_t const size)
+        {
+            auto const bucket = bucket_index(size);
+
+            if (bucket >= bucket_count || state() == pool_state::destroyed)
+            {
+                return ::operator new(bucket < bucket_count ? bucket_size(bucket) : size);
+            }
+
+            auto& list = instance().m_free[bucket];
+
+            if (!list.head)
+            {
+                return ::operator new(bucket_size(bucket));
+            }
+
+            auto result = list.head;
+            list.head = list.head->next;
+            --list.size;
+            return result;
+        }
+
+        static void deallocate(void* const pointer, std::size_t const size) noexcept
+        {
+            auto const bucket = bucket_index(size);
+
+            // The pool is not created just to hold a block, and once the thread's pool has been
+            // destroyed the block goes straight back to the heap.
+            if (bucket >= bucket_count || state() != pool_state::alive)
+            {
+                ::operator delete(pointer);
+                return;
+            }
+
+            auto& list = instance().m_free[bucket];
+
+            if (list.size == max_free_blocks)
+            {
+                ::operator delete(pointer);
+                return;
+            }
+
+            list.head = new (pointer) block{ list.head };
+            ++list.size;
+        }
+
+    private:
+
+        struct block
+        {
+            block* next;
+        };
+
+        struct free_list
+        {
+            block* head{};
+            std::size_t size{};
+        };
+
+        enum class pool_state : uint8_t
+        {
+            unused,
+            alive,
+            destroyed,
+        };
+
+        static constexpr std::size_t min_block_size = 16;
+        static constexpr std::size_t bucket_count = 8;
+        static constexpr std::size_t max_free_blocks = 256;
+
+        signature_pool() noexcept
+        {
+            state() = pool_state::alive;
+        }
+
+        ~signature_pool() noexcept
+        {
+            state() = pool_state::destroyed;
+
+            for (auto&& list : m_free)
+            {
+                while (list.head)
+                {
+                    ::operator delete(std::exchange(list.head, list.head->next));
+                }
+            }
+        }
+
+        // Trivially destructible, so it stays usable while the thread's pool is being destroyed
+        // and after.
+        static pool_state& state() noexcept
+        {
+            thread_local pool_state value{};
+            return value;
+        }
+
+        static signature_pool& instance() noexcept
+        {
+            thread_local signature_pool pool;
+            return pool;
+        }
+
+        static constexpr std::size_t bucket_size(std::size_t const bucket) noexcept
+        {
+            return min_block_size << bucket;
+        }
+
+        static constexpr std::size_t bucket_index(std::size_t const size) noexcept
+        {
+            std::size_t bucket{};
+
+            while (bucket < bucket_count && bucket_size(bucket) < size)
+            {
+                ++bucket;
+            }
+
+            return bucket;
+        }
+
+        std::array<free_list, bucket_count> m_free{};
+    };
+
+    template <typename T>
+    struct signature_allocator
+    {
+        using value_type = T;
+
+        signature_allocator() noexcept = default;
+
+        template <typename U>
+        signature_allocator(signature_allocator<U> const&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t const count)
+        {
+            return static_cast<T*>(signature_pool::allocate(count * sizeof(T)));
+        }
+
+        void deallocate(T* const pointer, std::size_t const count) noexcept
+        {
+            signature_pool::deallocate(pointer, count * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(signature_allocator<U> const&) const noexcept
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(signature_allocator<U> const&) const noexcept
+        {
+            return false;
+        }
+    };
+}
+
 namespace xlang::meta::reader
 {
+    template <typename T>
+    using signature_vector = std::vector<T, impl::signature_allocator<T>>;
+
     inline uint32_t uncompress_unsigned(byte_view& cursor)
     {
         auto data = cursor.begin();
@@ -120,12 +289,12 @@ namespace xlang::meta::reader
         ElementType m_class_or_value;
         coded_index<TypeDefOrRef> m_type;
         uint32_t m_generic_arg_count;
-        std::vector<TypeSig> m_generic_args;
+        signature_vector<TypeSig> m_generic_args;
     };
 
-    inline std::vector<CustomModSig> parse_cmods(table_base const* table, byte_view& data)
+    inline signature_vector<CustomModSig> parse_cmods(table_base const* table, byte_view& data)
     {
-        std::vector<CustomModSig> result;
+        signature_vector<CustomModSig> result;
         auto cursor = data;
 
         for (auto element_type = uncompress_enum<ElementType>(cursor);
@@ -193,7 +362,7 @@ namespace xlang::meta::reader
 
         static value_type ParseType(table_base const* table, byte_view& data);
         bool m_is_szarray;
-        std::vector<CustomModSig> m_cmod;
+        signature_vector<CustomModSig> m_cmod;
         ElementType m_element_type;
         value_type m_type;
     };
@@ -239,7 +408,7 @@ namespace xlang::meta::reader
         }
 
     private:
-        std::vector<CustomModSig> m_cmod;
+        signature_vector<CustomModSig> m_cmod;
         bool m_byref;
         TypeSig m_type;
     };
@@ -283,7 +452,7 @@ namespace xlang::meta::reader
         }
 
     private:
-        std::vector<CustomModSig> m_cmod;
+        signature_vector<CustomModSig> m_cmod;
         bool m_byref;
         std::optional<TypeSig> m_type;
     };
@@ -332,7 +501,7 @@ namespace xlang::meta::reader
         uint32_t m_generic_param_count;
         uint32_t m_param_count;
         RetTypeSig m_ret_type;
-        std::vector<ParamSig> m_params;
+        signature_vector<ParamSig> m_params;
     };
 
     struct FieldSig
@@ -364,7 +533,7 @@ namespace xlang::meta::reader
             return conv;
         }
         CallingConvention m_calling_convention;
-        std::vector<CustomModSig> m_cmod;
+        signature_vector<CustomModSig> m_cmod;
         TypeSig m_type;
     };
 
@@ -409,9 +578,9 @@ namespace xlang::meta::reader
         }
         CallingConvention m_calling_convention;
         uint32_t m_param_count;
-        std::vector<CustomModSig> m_cmod;
+        signature_vector<CustomModSig> m_cmod;
         TypeSig m_type;
-        std::vector<ParamSig> m_params;
+        signature_vector<ParamSig> m_params;
     };
 
     struct TypeSpecSig
@@ -0,0 +1,493 @@
+
+namespace xlang::impl
+{
+    // A cache snapshot is a flat little-endian file with every field aligned to its size:
+    //
+    //   header:     magic, version, checksum of everything that follows the header
+    //   inputs:     database count, then the path, file size, last write time and metadata
+    //               fingerprint of each input, in input order
+    //   type index: capacity, then the (hash, database, row) entries of the open-addressing table
+    //   namespaces: count, then for each namespace the slot lists of its types, interfaces, classes,
+    //               enums, structs, delegates, attributes and contracts
+    //   databases:  for each database, the resolved type index slot of each TypeRef row, then the
+    //               capacity and (parent, type hash, row) entries of its attribute index
+    //
+    // Names are not stored, they are read back from the string heaps of the databases. The type
+    // index and attribute indexes are stored in the same layout the cache probes, so they are used
+    // in place from the mapped snapshot. The namespace tables are rebuilt since namespaces() hands
+    // out std::map, but from slot lists that are already sorted and categorized.
+    //
+    // The metadata fingerprint covers the metadata root and stream headers, the table stream header
+    // with its row counts and the #GUID heap holding the module's MVID, so a rewritten input is
+    // detected even if its size and last write time are unchanged. A snapshot whose checksum does
+    // not match is treated like a stale one and the cache is indexed again.
+    struct snapshot_format
+    {
+        static constexpr uint32_t magic{ 0x73636c78 }; // "xlcs"
+        static constexpr uint32_t version{ 3 };
+        static constexpr uint32_t header_size{ 16 };
+    };
+
+    // FNV-1a over eight bytes at a time, which is enough to detect a damaged or truncated file
+    // without making the checksum a noticeable part of loading the snapshot.
+    inline uint64_t hash_bytes(uint8_t const* first, uint8_t const* const last, uint64_t hash = 0xcbf29ce484222325) noexcept
+    {
+        for (; last - first >= 8; first += 8)
+        {
+            uint64_t value;
+            std::memcpy(&value, first, sizeof(value));
+            hash = (hash ^ value) * 0x100000001b3;
+        }
+
+        for (; first != last; ++first)
+        {
+            hash = (hash ^ *first) * 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    struct snapshot_writer
+    {
+        template <typename T>
+        void write(T const value)
+        {
+            write_array(&value, 1);
+        }
+
+        void write(std::string_view const& value)
+        {
+            write(static_cast<uint32_t>(value.size()));
+            m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+        }
+
+        template <typename T>
+        void write_array(T const* const values, std::size_t const count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            align(alignof(T));
+            auto const offset = m_buffer.size();
+            m_buffer.resize(offset + count * sizeof(T));
+
+            if (count)
+            {
+                std::memcpy(m_buffer.data() + offset, values, count * sizeof(T));
+            }
+        }
+
+        std::vector<uint8_t> const& buffer() const noexcept
+        {
+            return m_buffer;
+        }
+
+        // Stores the checksum of everything following the header, which must already be written.
+        void seal() noexcept
+        {
+            XLANG_ASSERT(m_buffer.size() >= snapshot_format::header_size);
+            auto const checksum = hash_bytes(m_buffer.data() + snapshot_format::header_size, m_buffer.data() + m_buffer.size());
+            std::memcpy(m_buffer.data() + snapshot_format::header_size - sizeof(checksum), &checksum, sizeof(checksum));
+        }
+
+    private:
+
+        void align(std::size_t const alignment)
+        {
+            m_buffer.resize((m_buffer.size() + alignment - 1) & ~(alignment - 1));
+        }
+
+        std::vector<uint8_t> m_buffer;
+    };
+
+    struct snapshot_reader
+    {
+        explicit snapshot_reader(meta::reader::byte_view const& view) noexcept : m_view{ view }
+        {
+        }
+
+        template <typename T>
+        T read()
+        {
+            return *read_array<T>(1);
+        }
+
+        std::string_view read_string()
+        {
+            auto const length = read<uint32_t>();
+            auto const value = m_view.sub(m_offset, length);
+            m_offset += length;
+            return { reinterpret_cast<char const*>(value.begin()), length };
+        }
+
+        // Returns count values in place. The view starts on a page, so aligned offsets give aligned
+        // addresses.
+        template <typename T>
+        T const* read_array(uint64_t const count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            align(alignof(T));
+
+            if (m_offset > m_view.size() || count > (m_view.size() - m_offset) / sizeof(T))
+            {
+                throw_invalid("Invalid snapshot");
+            }
+
+            auto const values = reinterpret_cast<T const*>(m_view.begin() + m_offset);
+            m_offset += static_cast<uint32_t>(count * sizeof(T));
+            return values;
+        }
+
+    private:
+
+        void align(uint32_t const alignment) noexcept
+        {
+            m_offset = (m_offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        meta::reader::byte_view m_view;
+        uint32_t m_offset{};
+    };
+
+    struct snapshot_file
+    {
+        uint64_t size;
+        int64_t last_write_time;
+    };
+
+    inline std::optional<snapshot_file> get_snapshot_file(std::string const& path) noexcept
+    {
+        std::error_code error;
+        auto const size = std::filesystem::file_size(path, error);
+
+        if (error)
+        {
+            return {};
+        }
+
+        auto const last_write_time = std::filesystem::last_write_time(path, error);
+
+        if (error)
+        {
+            return {};
+        }
+
+        return snapshot_file{ size, static_cast<int64_t>(last_write_time.time_since_epoch().count()) };
+    }
+}
+
+namespace xlang::meta::reader
+{
+    inline uint64_t cache::get_fingerprint(database const& db) noexcept
+    {
+        auto hash = impl::hash_bytes(db.m_stream_headers.begin(), db.m_stream_headers.end());
+        hash = impl::hash_bytes(db.m_table_header.begin(), db.m_table_header.end(), hash);
+        return impl::hash_bytes(db.m_guids.begin(), db.m_guids.end(), hash);
+    }
+
+    inline bool cache::load_snapshot(std::vector<std::string> const& files, cache_options const& options)
+    {
+        using impl::snapshot_format;
+
+        std::error_code error;
+
+        if (!std::filesystem::is_regular_file(options.snapshot, error))
+        {
+            return false;
+        }
+
+        try
+        {
+            auto view = std::make_unique<file_view>(options.snapshot);
+            impl::snapshot_reader input{ *view };
+
+            if (view->size() < snapshot_format::header_size ||
+                input.read<uint32_t>() != snapshot_format::magic ||
+                input.read<uint32_t>() != snapshot_format::version ||
+                input.read<uint64_t>() != impl::hash_bytes(view->begin() + snapshot_format::header_size, view->end()) ||
+                input.read<uint32_t>() != files.size())
+            {
+                return false;
+            }
+
+            std::vector<uint64_t> fingerprints;
+            fingerprints.reserve(files.size());
+
+            for (auto&& file : files)
+            {
+                auto const identity = impl::get_snapshot_file(file);
+
+                if (input.read_string() != file ||
+                    !identity ||
+                    input.read<uint64_t>() != identity->size ||
+                    input.read<int64_t>() != identity->last_write_time)
+                {
+                    return false;
+                }
+
+                fingerprints.push_back(input.read<uint64_t>());
+            }
+
+            load(files, options, false);
+            index_databases();
+
+            for (std::size_t i{}; i != fingerprints.size(); ++i)
+            {
+                if (get_fingerprint(*m_database_index[i]) != fingerprints[i])
+                {
+                    throw_invalid("Stale snapshot");
+                }
+            }
+
+            // Every entry is checked against the databases once, so that lookups through the mapped
+            // tables never reach rows that don't exist or probe a table without an empty slot.
+            auto read_table = [&](auto& table, auto&& valid)
+            {
+                using entry_type = std::remove_const_t<std::remove_pointer_t<decltype(table.begin())>>;
+                auto const capacity = input.read<uint64_t>();
+
+                if (capacity & (capacity - 1))
+                {
+                    throw_invalid("Invalid snapshot");
+                }
+
+                auto const entries = input.read_array<entry_type>(capacity);
+                uint64_t occupied{};
+
+                for (uint64_t slot{}; slot != capacity; ++slot)
+                {
+                    if (entries[slot])
+                    {
+                        if (!valid(entries[slot]))
+                        {
+                            throw_invalid("Invalid snapshot");
+                        }
+
+                        ++occupied;
+                    }
+                }
+
+                if (capacity && occupied == capacity)
+                {
+                    throw_invalid("Invalid snapshot");
+                }
+
+                table.borrow(entries, static_cast<std::size_t>(capacity));
+            };
+
+            read_table(m_type_index, [&](type_index_entry const& entry)
+            {
+                return entry.database <= m_database_index.size() && entry.row < m_database_index[entry.database - 1]->TypeDef.size();
+            });
+
+            auto read_slot = [&]() -> type_index_entry const&
+            {
+                auto const slot = input.read<uint32_t>();
+
+                if (slot >= m_type_index.capacity() || !m_type_index.begin()[slot])
+                {
+                    throw_invalid("Invalid snapshot");
+                }
+
+                return m_type_index.begin()[slot];
+            };
+
+            auto const namespace_count = input.read<uint32_t>();
+
+            for (uint32_t i{}; i != namespace_count; ++i)
+            {
+                auto read_list = [&](std::vector<TypeDef>& list)
+                {
+                    list.resize(input.read<uint32_t>());
+
+                    for (auto&& type : list)
+                    {
+                        type = get_type(read_slot());
+                    }
+                };
+
+                auto const type_count = input.read<uint32_t>();
+
+                if (!type_count)
+                {
+                    throw_invalid("Invalid snapshot");
+                }
+
+                // Namespaces and types were written in map order, so each is placed at the end.
+                auto type = get_type(read_slot());
+                auto& members = m_namespaces.try_emplace(m_namespaces.end(), type.TypeNamespace())->second;
+                members.types.try_emplace(members.types.end(), type.TypeName(), type);
+
+                for (uint32_t index{ 1 }; index != type_count; ++index)
+                {
+                    type = get_type(read_slot());
+                    members.types.try_emplace(members.types.end(), type.TypeName(), type);
+                }
+
+                auto& categories = members.m_categories;
+                read_list(categories.interfaces);
+                read_list(categories.classes);
+                read_list(categories.enums);
+                read_list(categories.structs);
+                read_list(categories.delegates);
+                read_list(categories.attributes);
+                read_list(categories.contracts);
+
+                // The namespace was categorized when the snapshot was taken.
+                std::call_once(members.m_categorize_once, [] {});
+            }
+
+            for (auto&& db : m_databases)
+            {
+                auto const type_ref_count = input.read<uint32_t>();
+
+                if (type_ref_count != db.TypeRef.size())
+                {
+                    throw_invalid("Invalid snapshot");
+                }
+
+                auto const type_refs = input.read_array<uint32_t>(type_ref_count);
+
+                for (uint32_t row{}; row != type_ref_count; ++row)
+                {
+                    auto const resolved = type_refs[row];
+
+                    if (resolved != database::unresolved_type && resolved > m_type_index.capacity())
+                    {
+                        throw_invalid("Invalid snapshot");
+                    }
+
+                    db.m_type_refs[row].store(resolved, std::memory_order_relaxed);
+                }
+
+                std::call_once(db.m_attribute_once, [&]
+                {
+                    read_table(db.m_attributes, [&](database::attribute_entry const& entry)
+                    {
+                        return entry.row <= db.CustomAttribute.size();
+                    });
+                });
+            }
+
+            m_snapshot = std::move(view);
+        }
+        catch (std::exception const&)
+        {
+            m_namespaces.clear();
+            m_type_index.borrow(nullptr, 0);
+            m_database_index.clear();
+            m_databases.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    inline void cache::save_snapshot(std::vector<std::string> const& files, std::string const& path) const
+    {
+        using impl::snapshot_format;
+
+        auto slot = [&](TypeDef const& type)
+        {
+            return static_cast<uint32_t>(find_entry(type.TypeNamespace(), type.TypeName()) - m_type_index.begin());
+        };
+
+        impl::snapshot_writer output;
+        output.write(snapshot_format::magic);
+        output.write(snapshot_format::version);
+        output.write(uint64_t{});
+        output.write(static_cast<uint32_t>(files.size()));
+
+        for (std::size_t i{}; i != files.size(); ++i)
+        {
+            auto const identity = impl::get_snapshot_file(files[i]);
+
+            if (!identity)
+            {
+                return;
+            }
+
+            output.write(std::string_view{ files[i] });
+            output.write(identity->size);
+            output.write(identity->last_write_time);
+            output.write(get_fingerprint(*m_database_index[i]));
+        }
+
+        output.write(static_cast<uint64_t>(m_type_index.capacity()));
+        output.write_array(m_type_index.begin(), m_type_index.capacity());
+        output.write(static_cast<uint32_t>(namespaces().size()));
+
+        for (auto&&[namespace_name, members] : namespaces())
+        {
+            auto write_list = [&](std::vector<TypeDef> const& list)
+            {
+                output.write(static_cast<uint32_t>(list.size()));
+
+                for (auto&& type : list)
+                {
+                    output.write(slot(type));
+                }
+            };
+
+            output.write(static_cast<uint32_t>(members.types.size()));
+
+            for (auto&&[name, type] : members.types)
+            {
+                output.write(slot(type));
+            }
+
+            write_list(members.interfaces());
+            write_list(members.classes());
+            write_list(members.enums());
+            write_list(members.structs());
+            write_list(members.delegates());
+            write_list(members.attributes());
+            write_list(members.contracts());
+        }
+
+        for (auto&& db : m_databases)
+        {
+            std::vector<uint32_t> type_refs;
+            type_refs.reserve(db.TypeRef.size());
+
+            for (auto&& type : db.TypeRef)
+            {
+                db.resolve(type);
+                type_refs.push_back(db.m_type_refs[type.index()].load(std::memory_order_relaxed));
+            }
+
+            output.write(static_cast<uint32_t>(type_refs.size()));
+            output.write_array(type_refs.data(), type_refs.size());
+
+            db.index_attributes();
+            output.write(static_cast<uint64_t>(db.m_attributes.capacity()));
+            output.write_array(db.m_attributes.begin(), db.m_attributes.capacity());
+        }
+
+        output.seal();
+
+        // The snapshot is written next to its final path and renamed into place so that concurrent
+        // builds never observe a partially written file. Failing to save it is not an error.
+        std::error_code error;
+        std::filesystem::path const target{ path };
+        auto temporary = target;
+        temporary += "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+
+        {
+            std::ofstream stream{ temporary, std::ios::out | std::ios::binary | std::ios::trunc };
+            stream.write(reinterpret_cast<char const*>(output.buffer().data()), output.buffer().size());
+
+            if (!stream)
+            {
+                stream.close();
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporary, target, error);
+
+        if (error)
+        {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+}
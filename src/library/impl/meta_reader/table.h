@@ -30,43 +30,20 @@ namespace xlang::meta::reader
             return m_columns[column].size;
         }
 
+        // Rows and index columns are validated when the database is loaded and the table data is
+        // followed by at least eight readable bytes, so a column is read with a single unaligned
+        // load and a mask rather than a bounds check and a switch on the column width.
         template <typename T>
-        T get_value(uint32_t const row, uint32_t const column) const
+        T get_value(uint32_t const row, uint32_t const column) const noexcept
         {
             static_assert(std::is_enum_v<T> || std::is_integral_v<T>);
-            uint32_t const data_size = m_columns[column].size;
-            XLANG_ASSERT(data_size == 1 || data_size == 2 || data_size == 4 || data_size == 8);
-            XLANG_ASSERT(data_size <= sizeof(T));
+            XLANG_ASSERT(m_columns[column].size == 1 || m_columns[column].size == 2 || m_columns[column].size == 4 || m_columns[column].size == 8);
+            XLANG_ASSERT(m_columns[column].size <= sizeof(T));
+            XLANG_ASSERT(row < size());
 
-            if (row > size())
-            {
-                throw_invalid("Invalid row index");
-            }
-
-            uint8_t const* ptr = m_data + row * m_row_size + m_columns[column].offset;
-            switch (data_size)
-            {
-            case  1:
-            {
-                uint8_t temp = *ptr;
-                return static_cast<T>(temp);
-            }
-            case 2:
-            {
-                uint16_t temp = *reinterpret_cast<uint16_t const*>(ptr);
-                return static_cast<T>(temp);
-            }
-            case 4:
-            {
-                uint32_t temp = *reinterpret_cast<uint32_t const*>(ptr);
-                return static_cast<T>(temp);
-            }
-            default:
-            {
-                uint64_t temp = *reinterpret_cast<uint64_t const*>(ptr);
-                return static_cast<T>(temp);
-            }
-            }
+            uint64_t value;
+            std::memcpy(&value, m_data + row * m_row_size + m_columns[column].offset, sizeof(value));
+            return static_cast<T>(value & m_columns[column].mask);
         }
 
     private:
@@ -75,6 +52,7 @@ namespace xlang::meta::reader
 
         struct column
         {
+            uint64_t mask;
             uint8_t offset;
             uint8_t size;
         };
@@ -105,26 +83,38 @@ namespace xlang::meta::reader
             m_row_size = a + b + c + d + e + f;
             XLANG_ASSERT(m_row_size < UINT8_MAX);
 
-            m_columns[0] = { 0, a };
-            if (b) { m_columns[1] = { static_cast<uint8_t>(a), b }; }
-            if (c) { m_columns[2] = { static_cast<uint8_t>(a + b), c }; }
-            if (d) { m_columns[3] = { static_cast<uint8_t>(a + b + c), d }; }
-            if (e) { m_columns[4] = { static_cast<uint8_t>(a + b + c + d), e }; }
-            if (f) { m_columns[5] = { static_cast<uint8_t>(a + b + c + d + e), f }; }
+            m_columns[0] = { column_mask(a), 0, a };
+            if (b) { m_columns[1] = { column_mask(b), static_cast<uint8_t>(a), b }; }
+            if (c) { m_columns[2] = { column_mask(c), static_cast<uint8_t>(a + b), c }; }
+            if (d) { m_columns[3] = { column_mask(d), static_cast<uint8_t>(a + b + c), d }; }
+            if (e) { m_columns[4] = { column_mask(e), static_cast<uint8_t>(a + b + c + d), e }; }
+            if (f) { m_columns[5] = { column_mask(f), static_cast<uint8_t>(a + b + c + d + e), f }; }
         }
 
-        void set_data(byte_view& view) noexcept
+        void set_data(byte_view& view)
         {
             XLANG_ASSERT(!m_data);
 
             if (m_row_count)
             {
                 XLANG_ASSERT(m_row_size);
+                uint64_t const data_size = uint64_t{ m_row_count } * m_row_size;
+
+                if (data_size > view.size())
+                {
+                    throw_invalid("Buffer too small");
+                }
+
                 m_data = view.begin();
-                view = view.seek(m_row_count * m_row_size);
+                view = view.seek(static_cast<uint32_t>(data_size));
             }
         }
 
+        static constexpr uint64_t column_mask(uint8_t const size) noexcept
+        {
+            return size == 8 ? ~0ull : (1ull << (size * 8)) - 1;
+        }
+
         uint8_t index_size() const noexcept
         {
             return m_row_count < (1 << 16) ? 2 : 4;
@@ -139,6 +139,30 @@ namespace xlang::meta::reader
         uint8_t const* m_last{};
     };
 
+    struct file_view_options
+    {
+        // Faults in the whole file when it is mapped. Otherwise pages are read on first access, which
+        // suits large inputs that are only partly read. Files have always been populated on POSIX
+        // systems but not on Windows, so that is the default.
+        bool populate{ !XLANG_PLATFORM_WINDOWS };
+
+        // Lets a database pass access hints for its table stream and heaps to the operating system
+        // once it has located them, see file_view::advise. This mostly helps when the file is not
+        // populated.
+        bool advise{};
+
+        // Asks for the mapping to be backed by transparent huge pages where the platform supports it.
+        bool huge_pages{};
+    };
+
+    enum class file_advice
+    {
+        normal,
+        sequential,
+        random,
+        will_need,
+    };
+
     struct file_view : byte_view
     {
         file_view(file_view const&) = delete;
@@ -146,7 +170,7 @@ namespace xlang::meta::reader
         file_view(file_view&&) noexcept = default;
         file_view& operator=(file_view&&) noexcept = default;
 
-        file_view(std::string_view const& path) : byte_view{ open_file(path) }, m_backed_by_file{ true }
+        file_view(std::string_view const& path, file_view_options const& options = {}) : byte_view{ open_file(path, options) }, m_backed_by_file{ true }
         {
         }
 
@@ -166,6 +190,52 @@ namespace xlang::meta::reader
             }
         }
 
+        // Tells the operating system how a region of the file will be accessed. This is only a hint
+        // and does nothing for views that are not backed by a mapped file. The region must lie within
+        // the view.
+        void advise(byte_view const& region, file_advice const advice) const noexcept
+        {
+            if (!region)
+            {
+                return;
+            }
+
+            XLANG_ASSERT(region.begin() >= begin() && region.end() <= end());
+
+            if (!m_backed_by_file || region.begin() < begin() || region.end() > end())
+            {
+                return;
+            }
+
+#if XLANG_PLATFORM_WINDOWS
+            if (advice == file_advice::will_need)
+            {
+                WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(region.begin()), region.size() };
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            }
+#else
+            // madvise requires a page-aligned address, and the mapping itself starts on a page.
+            auto const page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            auto const first = begin() + (region.begin() - begin()) / page_size * page_size;
+
+            switch (advice)
+            {
+            case file_advice::normal:
+                madvise(const_cast<uint8_t*>(first), region.end() - first, MADV_NORMAL);
+                break;
+            case file_advice::sequential:
+                madvise(const_cast<uint8_t*>(first), region.end() - first, MADV_SEQUENTIAL);
+                break;
+            case file_advice::random:
+                madvise(const_cast<uint8_t*>(first), region.end() - first, MADV_RANDOM);
+                break;
+            case file_advice::will_need:
+                madvise(const_cast<uint8_t*>(first), region.end() - first, MADV_WILLNEED);
+                break;
+            }
+#endif
+        }
+
     private:
 
         bool m_backed_by_file;
@@ -219,7 +289,7 @@ namespace xlang::meta::reader
             }
         };
 
-        static byte_view open_file(std::string_view const& path)
+        static byte_view open_file(std::string_view const& path, file_view_options const& options)
         {
 #if XLANG_PLATFORM_WINDOWS
             auto input = c_str(path);
@@ -265,6 +335,13 @@ namespace xlang::meta::reader
             }
 
             auto const first{ static_cast<uint8_t const*>(MapViewOfFile(mapping.value, FILE_MAP_READ, 0, 0, 0)) };
+
+            if (options.populate)
+            {
+                WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(first), static_cast<SIZE_T>(size.QuadPart) };
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            }
+
             return{ first, first + size.QuadPart };
 #else
             file_handle file{ open(c_str(path), O_RDONLY, 0) };
@@ -284,11 +361,24 @@ namespace xlang::meta::reader
                 return{};
             }
 
-            auto const first = static_cast<uint8_t const*>(mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, file.value, 0));
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            if (options.populate)
+            {
+                flags |= MAP_POPULATE;
+            }
+#endif
+            auto const first = static_cast<uint8_t const*>(mmap(nullptr, st.st_size, PROT_READ, flags, file.value, 0));
             if (first == MAP_FAILED)
             {
                 throw_invalid("Could not open file '", path, "'");
             }
+#ifdef MADV_HUGEPAGE
+            if (options.huge_pages)
+            {
+                madvise(const_cast<uint8_t*>(first), st.st_size, MADV_HUGEPAGE);
+            }
+#endif
 
             return{ first, first + st.st_size };
 #endif
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "../base.h"
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+namespace xlang::meta::writer
+{
+    inline void compress_unsigned(std::vector<uint8_t>& output, uint32_t const value)
+    {
+        if (value < 0x80)
+        {
+            output.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value < 0x4000)
+        {
+            output.push_back(static_cast<uint8_t>(0x80 | (value >> 8)));
+            output.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value < 0x20000000)
+        {
+            output.push_back(static_cast<uint8_t>(0xc0 | (value >> 24)));
+            output.push_back(static_cast<uint8_t>(value >> 16));
+            output.push_back(static_cast<uint8_t>(value >> 8));
+            output.push_back(static_cast<uint8_t>(value));
+        }
+        else
+        {
+            throw_invalid("Value is too large to compress");
+        }
+    }
+
+    // Finds heap entries by content so that each distinct string, blob or GUID is stored once.
+    // Entries are compared against the heap bytes themselves, so only offsets are kept here.
+    struct heap_index
+    {
+        template <typename Append>
+        uint32_t find_or_add(std::vector<uint8_t>& data, uint8_t const* const first, uint32_t const size, Append&& append)
+        {
+            XLANG_ASSERT(size);
+
+            if (m_count * 2 >= m_entries.size())
+            {
+                grow();
+            }
+
+            auto const hash = hash_bytes(first, size);
+            auto const mask = m_entries.size() - 1;
+
+            for (auto slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                auto& entry = m_entries[slot];
+
+                if (!entry.size)
+                {
+                    auto const [value, content] = append();
+                    entry = { hash, value, content, size };
+                    ++m_count;
+                    return value;
+                }
+
+                if (entry.hash == hash && entry.size == size && std::memcmp(data.data() + entry.content, first, size) == 0)
+                {
+                    return entry.value;
+                }
+            }
+        }
+
+    private:
+
+        struct entry
+        {
+            uint64_t hash;
+            uint32_t value;
+            uint32_t content;
+            uint32_t size;
+        };
+
+        static uint64_t hash_bytes(uint8_t const* first, uint32_t size) noexcept
+        {
+            uint64_t hash{ 14695981039346656037ull };
+
+            for (; size; --size, ++first)
+            {
+                hash = (hash ^ *first) * 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        void grow()
+        {
+            std::vector<entry> entries(std::max<std::size_t>(1024, m_entries.size() * 2));
+            auto const mask = entries.size() - 1;
+
+            for (auto&& entry : m_entries)
+            {
+                if (!entry.size)
+                {
+                    continue;
+                }
+
+                auto slot = entry.hash & mask;
+
+                while (entries[slot].size)
+                {
+                    slot = (slot + 1) & mask;
+                }
+
+                entries[slot] = entry;
+            }
+
+            m_entries.swap(entries);
+        }
+
+        std::vector<entry> m_entries;
+        std::size_t m_count{};
+    };
+
+    struct string_heap
+    {
+        string_heap() : m_data(1)
+        {
+        }
+
+        uint32_t add(std::string_view const& value)
+        {
+            if (value.empty())
+            {
+                return 0;
+            }
+
+            auto const first = reinterpret_cast<uint8_t const*>(value.data());
+            auto const size = static_cast<uint32_t>(value.size());
+
+            return m_index.find_or_add(m_data, first, size, [&]
+            {
+                auto const offset = static_cast<uint32_t>(m_data.size());
+                m_data.insert(m_data.end(), first, first + size);
+                m_data.push_back(0);
+                return std::pair{ offset, offset };
+            });
+        }
+
+        std::vector<uint8_t> const& data() const noexcept
+        {
+            return m_data;
+        }
+
+    private:
+
+        std::vector<uint8_t> m_data;
+        heap_index m_index;
+    };
+
+    struct blob_heap
+    {
+        blob_heap() : m_data(1)
+        {
+        }
+
+        uint32_t add(uint8_t const* const first, uint32_t const size)
+        {
+            if (!size)
+            {
+                return 0;
+            }
+
+            return m_index.find_or_add(m_data, first, size, [&]
+            {
+                auto const offset = static_cast<uint32_t>(m_data.size());
+                compress_unsigned(m_data, size);
+                auto const content = static_cast<uint32_t>(m_data.size());
+                m_data.insert(m_data.end(), first, first + size);
+                return std::pair{ offset, content };
+            });
+        }
+
+        uint32_t add(std::vector<uint8_t> const& value)
+        {
+            return add(value.data(), static_cast<uint32_t>(value.size()));
+        }
+
+        std::vector<uint8_t> const& data() const noexcept
+        {
+            return m_data;
+        }
+
+    private:
+
+        std::vector<uint8_t> m_data;
+        heap_index m_index;
+    };
+
+    struct guid_heap
+    {
+        // Returns the one-based index of the 16-byte GUID at first.
+        uint32_t add(uint8_t const* const first)
+        {
+            return m_index.find_or_add(m_data, first, 16, [&]
+            {
+                auto const content = static_cast<uint32_t>(m_data.size());
+                m_data.insert(m_data.end(), first, first + 16);
+                return std::pair{ content / 16 + 1, content };
+            });
+        }
+
+        std::vector<uint8_t> const& data() const noexcept
+        {
+            return m_data;
+        }
+
+    private:
+
+        std::vector<uint8_t> m_data;
+        heap_index m_index;
+    };
+}
@@ -0,0 +1,1101 @@
+#pragma once
+
+#include "../../meta_reader.h"
+#include "metadata_writer.h"
+#include <functional>
+
+namespace xlang::meta::writer
+{
+    inline reader::table_base const& get_table(reader::database const& db, table_id const table)
+    {
+        switch (table)
+        {
+        case table_id::Module: return db.Module;
+        case table_id::TypeRef: return db.TypeRef;
+        case table_id::TypeDef: return db.TypeDef;
+        case table_id::Field: return db.Field;
+        case table_id::MethodDef: return db.MethodDef;
+        case table_id::Param: return db.Param;
+        case table_id::InterfaceImpl: return db.InterfaceImpl;
+        case table_id::MemberRef: return db.MemberRef;
+        case table_id::Constant: return db.Constant;
+        case table_id::CustomAttribute: return db.CustomAttribute;
+        case table_id::FieldMarshal: return db.FieldMarshal;
+        case table_id::DeclSecurity: return db.DeclSecurity;
+        case table_id::ClassLayout: return db.ClassLayout;
+        case table_id::FieldLayout: return db.FieldLayout;
+        case table_id::StandAloneSig: return db.StandAloneSig;
+        case table_id::EventMap: return db.EventMap;
+        case table_id::Event: return db.Event;
+        case table_id::PropertyMap: return db.PropertyMap;
+        case table_id::Property: return db.Property;
+        case table_id::MethodSemantics: return db.MethodSemantics;
+        case table_id::MethodImpl: return db.MethodImpl;
+        case table_id::ModuleRef: return db.ModuleRef;
+        case table_id::TypeSpec: return db.TypeSpec;
+        case table_id::ImplMap: return db.ImplMap;
+        case table_id::FieldRVA: return db.FieldRVA;
+        case table_id::Assembly: return db.Assembly;
+        case table_id::AssemblyProcessor: return db.AssemblyProcessor;
+        case table_id::AssemblyOS: return db.AssemblyOS;
+        case table_id::AssemblyRef: return db.AssemblyRef;
+        case table_id::AssemblyRefProcessor: return db.AssemblyRefProcessor;
+        case table_id::AssemblyRefOS: return db.AssemblyRefOS;
+        case table_id::File: return db.File;
+        case table_id::ExportedType: return db.ExportedType;
+        case table_id::ManifestResource: return db.ManifestResource;
+        case table_id::NestedClass: return db.NestedClass;
+        case table_id::GenericParam: return db.GenericParam;
+        case table_id::MethodSpec: return db.MethodSpec;
+        case table_id::GenericParamConstraint: return db.GenericParamConstraint;
+        }
+
+        throw_invalid("Unknown metadata table");
+    }
+
+    // Combines several databases into a single module, such as one winmd per product built from
+    // dozens of component winmds. A filter can trim the output to the types it accepts; nested types
+    // follow their enclosing type and members follow their parent. References to types that are
+    // left out become TypeRefs to the assembly that defined them. When more than one database
+    // defines a type, the first definition is kept and references to the others are redirected to it.
+    //
+    // References between the databases are resolved by name: TypeRefs to types defined in the
+    // merged module become TypeDefs and MemberRefs to their methods and fields become MethodDefs and
+    // Fields. TypeRef, MemberRef, TypeSpec and AssemblyRef rows are only written once a row that
+    // is kept refers to them, so references made only by types that are left out go with them.
+    //
+    // The obsolete AssemblyOS, AssemblyProcessor, AssemblyRefOS and AssemblyRefProcessor tables are
+    // not carried over.
+    struct merge_writer
+    {
+        explicit merge_writer(std::string_view const& name) : m_name{ name }
+        {
+        }
+
+        void filter(std::function<bool(reader::TypeDef const&)> filter)
+        {
+            m_filter = std::move(filter);
+        }
+
+        // The database must outlive the merge_writer.
+        void add(reader::database const& db)
+        {
+            XLANG_ASSERT(!m_merged);
+            m_sources.emplace_back().db = &db;
+        }
+
+        metadata_writer const& merge()
+        {
+            if (!m_merged)
+            {
+                m_merged = true;
+                decide();
+                assign();
+                write_rows();
+                write_sorted_rows();
+            }
+
+            return m_writer;
+        }
+
+        std::vector<uint8_t> save_to_memory()
+        {
+            pe_writer writer;
+            writer.add_metadata(merge().save());
+            return writer.save_to_memory();
+        }
+
+        void save_to_file(std::filesystem::path const& path)
+        {
+            merge().save_to_file(path);
+        }
+
+    private:
+
+        using row_values = std::array<uint64_t, 6>;
+
+        // Tables whose rows keep their relative order, so that each source's rows map to a
+        // contiguous range and runs owned through list columns stay contiguous.
+        static constexpr std::array<table_id, 13> concatenated_tables
+        {
+            table_id::TypeDef,
+            table_id::Field,
+            table_id::MethodDef,
+            table_id::Param,
+            table_id::StandAloneSig,
+            table_id::EventMap,
+            table_id::Event,
+            table_id::PropertyMap,
+            table_id::Property,
+            table_id::File,
+            table_id::ExportedType,
+            table_id::ManifestResource,
+            table_id::MethodSpec,
+        };
+
+        // Tables that must be sorted by their key columns, in an order where each table's keys
+        // only refer to tables that are already final.
+        struct sorted_table
+        {
+            table_id table;
+            uint32_t key;
+            std::optional<uint32_t> secondary;
+        };
+
+        inline static std::array<sorted_table, 14> const sorted_tables
+        { {
+            { table_id::InterfaceImpl, 0, 1 },
+            { table_id::GenericParam, 2, 0 },
+            { table_id::GenericParamConstraint, 0, {} },
+            { table_id::DeclSecurity, 1, {} },
+            { table_id::Constant, 1, {} },
+            { table_id::FieldMarshal, 0, {} },
+            { table_id::ClassLayout, 2, {} },
+            { table_id::FieldLayout, 1, {} },
+            { table_id::MethodSemantics, 2, {} },
+            { table_id::MethodImpl, 0, {} },
+            { table_id::ImplMap, 1, {} },
+            { table_id::FieldRVA, 1, {} },
+            { table_id::NestedClass, 0, {} },
+            { table_id::CustomAttribute, 0, {} },
+        } };
+
+        struct member_definition
+        {
+            table_id table;
+            uint32_t source;
+            uint32_t row;
+        };
+
+        struct source
+        {
+            reader::database const* db{};
+
+            // New one-based index of each row, or zero if the row is left out.
+            std::array<std::vector<uint32_t>, table_count> rows;
+
+            // Whether each row of a concatenated table is kept.
+            std::array<std::vector<bool>, table_count> keep;
+
+            // New list column value for each old list column value, for the tables that are owned
+            // through list columns.
+            std::array<std::vector<uint32_t>, table_count> lists;
+
+            // One-based enclosing TypeDef row of each nested TypeDef row.
+            std::vector<uint32_t> enclosing;
+
+            std::vector<uint32_t> method_owner;
+
+            // For each TypeDef that is also defined by an earlier source, that source plus one
+            // and its row.
+            std::vector<std::pair<uint32_t, uint32_t>> duplicates;
+
+            // Full name of each TypeDef and TypeRef, with nested types following their enclosing type.
+            std::vector<std::string> type_names;
+            std::vector<std::string> ref_names;
+
+            // For each TypeRef to a type defined in the merged module, the defining source plus one
+            // and its row.
+            std::vector<std::pair<uint32_t, uint32_t>> ref_definitions;
+
+            // For each MemberRef to a method or field defined in the merged module, the defining
+            // source plus one and its row.
+            std::vector<member_definition> member_definitions;
+
+            std::vector<uint32_t> type_refs;
+            std::vector<uint32_t> member_refs;
+            uint32_t assembly_ref{};
+        };
+
+        static uint32_t get_value(reader::database const& db, table_id const table, uint32_t const row, uint32_t const column)
+        {
+            return get_table(db, table).get_value<uint32_t>(row, column);
+        }
+
+        // Returns the table and zero-based row of a non-null coded index.
+        static std::pair<table_id, uint32_t> decode(coded_index_id const id, uint32_t const value)
+        {
+            auto const& schema = get_coded_index_schema(id);
+            auto const tag = value & ((1u << schema.bits) - 1);
+
+            if (tag >= schema.count || schema.tables[tag] == 0xff)
+            {
+                throw_invalid("Invalid coded index");
+            }
+
+            return { static_cast<table_id>(schema.tables[tag]), (value >> schema.bits) - 1 };
+        }
+
+        // Returns the range of child rows that an owner row owns through the list column.
+        static std::pair<uint32_t, uint32_t> get_run(reader::database const& db, table_id const owner, uint32_t const column, table_id const child, uint32_t const row)
+        {
+            auto const first = get_value(db, owner, row, column) - 1;
+            auto const last = row + 1 < get_table(db, owner).size() ? get_value(db, owner, row + 1, column) - 1 : get_table(db, child).size();
+            return { first, last };
+        }
+
+        static std::string get_type_name(reader::database const& db, std::vector<uint32_t> const& enclosing, uint32_t row)
+        {
+            std::string name{ reader::TypeDef{ &db.TypeDef, row }.TypeName() };
+
+            while (enclosing[row])
+            {
+                row = enclosing[row] - 1;
+                name = std::string{ reader::TypeDef{ &db.TypeDef, row }.TypeName() } + '/' + name;
+            }
+
+            return std::string{ reader::TypeDef{ &db.TypeDef, row }.TypeNamespace() } + '.' + name;
+        }
+
+        // Returns the zero-based TypeRef row that a TypeRef is nested in, if any.
+        static std::optional<uint32_t> get_enclosing_ref(reader::database const& db, uint32_t const row)
+        {
+            auto const scope = get_value(db, table_id::TypeRef, row, 0);
+
+            if (!scope)
+            {
+                return {};
+            }
+
+            auto const [table, result] = decode(coded_index_id::ResolutionScope, scope);
+
+            if (table != table_id::TypeRef)
+            {
+                return {};
+            }
+
+            return result;
+        }
+
+        static std::string get_ref_name(reader::database const& db, uint32_t row)
+        {
+            std::string name{ reader::TypeRef{ &db.TypeRef, row }.TypeName() };
+
+            for (uint32_t depth{}; auto const scope = get_enclosing_ref(db, row); ++depth)
+            {
+                if (depth == db.TypeRef.size())
+                {
+                    throw_invalid("Invalid type reference");
+                }
+
+                row = *scope;
+                name = std::string{ reader::TypeRef{ &db.TypeRef, row }.TypeName() } + '/' + name;
+            }
+
+            return std::string{ reader::TypeRef{ &db.TypeRef, row }.TypeNamespace() } + '.' + name;
+        }
+
+        // Calls callback with each owner row and the range of child rows it owns through the list column.
+        template <typename F>
+        static void for_each_run(reader::database const& db, table_id const owner, uint32_t const column, table_id const child, F&& callback)
+        {
+            auto const owners = get_table(db, owner).size();
+            auto const children = get_table(db, child).size();
+
+            for (uint32_t row{}; row < owners; ++row)
+            {
+                auto const first = get_value(db, owner, row, column) - 1;
+                auto const last = row + 1 < owners ? get_value(db, owner, row + 1, column) - 1 : children;
+                callback(row, first, last);
+            }
+        }
+
+        void decide()
+        {
+            std::map<std::string, std::pair<uint32_t, uint32_t>> definitions;
+
+            for (uint32_t index{}; index < m_sources.size(); ++index)
+            {
+                auto& s = m_sources[index];
+                auto const& db = *s.db;
+
+                for (uint8_t table{}; table < table_count; ++table)
+                {
+                    if (get_table_schema(static_cast<table_id>(table)).column_count)
+                    {
+                        auto const size = get_table(db, static_cast<table_id>(table)).size();
+                        s.rows[table].resize(size);
+                        s.keep[table].assign(size, true);
+                    }
+                }
+
+                auto const type_count = db.TypeDef.size();
+                s.enclosing.resize(type_count);
+                s.duplicates.resize(type_count);
+                s.type_refs.resize(type_count);
+                s.method_owner.resize(db.MethodDef.size());
+                s.member_refs.resize(db.MethodDef.size());
+
+                for (uint32_t row{}; row < db.NestedClass.size(); ++row)
+                {
+                    s.enclosing[get_value(db, table_id::NestedClass, row, 0) - 1] = get_value(db, table_id::NestedClass, row, 1);
+                }
+
+                s.type_names.resize(type_count);
+
+                for (uint32_t row{}; row < type_count; ++row)
+                {
+                    s.type_names[row] = get_type_name(db, s.enclosing, row);
+                }
+
+                auto& types = s.keep[static_cast<uint8_t>(table_id::TypeDef)];
+
+                for (uint32_t row{}; row < type_count; ++row)
+                {
+                    if (s.enclosing[row])
+                    {
+                        continue;
+                    }
+
+                    reader::TypeDef const type{ &db.TypeDef, row };
+
+                    if (row == 0 && type.TypeName() == "<Module>"sv)
+                    {
+                        types[row] = index == 0;
+                    }
+                    else if (m_filter && !m_filter(type))
+                    {
+                        types[row] = false;
+                    }
+                    else if (auto [pos, added] = definitions.try_emplace(s.type_names[row], index, row); !added)
+                    {
+                        types[row] = false;
+                        s.duplicates[row] = { pos->second.first + 1, pos->second.second };
+                    }
+                }
+
+                for (uint32_t row{}; row < type_count; ++row)
+                {
+                    auto outer = row;
+
+                    while (s.enclosing[outer])
+                    {
+                        outer = s.enclosing[outer] - 1;
+                    }
+
+                    types[row] = types[outer];
+
+                    if (outer == row)
+                    {
+                        continue;
+                    }
+
+                    // Nested types are defined along with their enclosing type, so the nested types
+                    // of a duplicate are redirected to those of the kept definition.
+                    if (types[row])
+                    {
+                        definitions.try_emplace(s.type_names[row], index, row);
+                    }
+                    else if (s.duplicates[outer].first)
+                    {
+                        if (auto const found = definitions.find(s.type_names[row]); found != definitions.end())
+                        {
+                            s.duplicates[row] = { found->second.first + 1, found->second.second };
+                        }
+                    }
+                }
+
+                auto inherit = [&](table_id const owner, uint32_t const column, table_id const child)
+                {
+                    auto const& owners = s.keep[static_cast<uint8_t>(owner)];
+                    auto& children = s.keep[static_cast<uint8_t>(child)];
+
+                    for_each_run(db, owner, column, child, [&](uint32_t const row, uint32_t const first, uint32_t const last)
+                    {
+                        std::fill(children.begin() + first, children.begin() + last, owners[row]);
+                    });
+                };
+
+                inherit(table_id::TypeDef, 4, table_id::Field);
+                inherit(table_id::TypeDef, 5, table_id::MethodDef);
+                inherit(table_id::MethodDef, 5, table_id::Param);
+
+                for_each_run(db, table_id::TypeDef, 5, table_id::MethodDef, [&](uint32_t const row, uint32_t const first, uint32_t const last)
+                {
+                    std::fill(s.method_owner.begin() + first, s.method_owner.begin() + last, row);
+                });
+
+                for (auto&& [map, list] : { std::pair{ table_id::PropertyMap, table_id::Property }, std::pair{ table_id::EventMap, table_id::Event } })
+                {
+                    auto& maps = s.keep[static_cast<uint8_t>(map)];
+
+                    for (uint32_t row{}; row < maps.size(); ++row)
+                    {
+                        maps[row] = types[get_value(db, map, row, 0) - 1];
+                    }
+
+                    inherit(map, 1, list);
+                }
+            }
+
+            for (auto&& s : m_sources)
+            {
+                resolve_type_refs(s, definitions);
+            }
+
+            for (uint32_t index{}; index < m_sources.size(); ++index)
+            {
+                resolve_member_refs(index);
+            }
+        }
+
+        void resolve_type_refs(source& s, std::map<std::string, std::pair<uint32_t, uint32_t>> const& definitions)
+        {
+            auto const& db = *s.db;
+            auto const count = db.TypeRef.size();
+            s.ref_names.resize(count);
+            s.ref_definitions.resize(count);
+
+            for (uint32_t row{}; row < count; ++row)
+            {
+                s.ref_names[row] = get_ref_name(db, row);
+
+                if (auto const found = definitions.find(s.ref_names[row]); found != definitions.end())
+                {
+                    s.ref_definitions[row] = { found->second.first + 1, found->second.second };
+                }
+            }
+        }
+
+        void resolve_member_refs(uint32_t const index)
+        {
+            auto& s = m_sources[index];
+            auto const& db = *s.db;
+            s.member_definitions.resize(db.MemberRef.size());
+
+            for (uint32_t row{}; row < db.MemberRef.size(); ++row)
+            {
+                auto const value = get_value(db, table_id::MemberRef, row, 0);
+
+                if (!value)
+                {
+                    continue;
+                }
+
+                auto const [parent, parent_row] = decode(coded_index_id::MemberRefParent, value);
+                std::pair<uint32_t, uint32_t> type{};
+
+                if (parent == table_id::TypeRef)
+                {
+                    type = s.ref_definitions[parent_row];
+                }
+                else if (parent == table_id::TypeDef)
+                {
+                    type = s.keep[static_cast<uint8_t>(table_id::TypeDef)][parent_row] ? std::pair{ index + 1, parent_row } : s.duplicates[parent_row];
+                }
+
+                if (!type.first)
+                {
+                    continue;
+                }
+
+                if (auto const member = find_member(s, row, type.first - 1, type.second))
+                {
+                    s.member_definitions[row] = *member;
+                }
+            }
+        }
+
+        // Finds the kept method or field of a type that matches a MemberRef by name and signature.
+        std::optional<member_definition> find_member(source const& s, uint32_t const row, uint32_t const index, uint32_t const type)
+        {
+            auto const& db = *s.db;
+            auto const& target = m_sources[index];
+            auto const name = db.get_string(get_value(db, table_id::MemberRef, row, 1));
+            auto const signature_index = get_value(db, table_id::MemberRef, row, 2);
+            auto const field = (db.get_blob(signature_index).as<uint8_t>() & 0x0f) == 0x06;
+            auto const table = field ? table_id::Field : table_id::MethodDef;
+            auto const name_column = field ? 1 : 3;
+            auto const signature = get_canonical_signature(s, signature_index, false);
+            auto const [first, last] = get_run(*target.db, table_id::TypeDef, field ? 4 : 5, table, type);
+
+            for (auto member = first; member < last; ++member)
+            {
+                if (target.keep[static_cast<uint8_t>(table)][member] &&
+                    target.db->get_string(get_value(*target.db, table, member, name_column)) == name &&
+                    get_canonical_signature(target, get_value(*target.db, table, member, name_column + 1), false) == signature)
+                {
+                    return member_definition{ table, index + 1, member };
+                }
+            }
+
+            return {};
+        }
+
+        void assign()
+        {
+            if (m_sources.empty())
+            {
+                throw_invalid("No databases to merge");
+            }
+
+            auto& first = m_sources.front();
+            row_values values;
+
+            if (first.db->Module.size())
+            {
+                remap_row(first, table_id::Module, 0, values);
+                values[1] = m_writer.strings().add(m_name + ".winmd");
+                first.rows[static_cast<uint8_t>(table_id::Module)][0] = m_writer.add_row(table_id::Module, values);
+            }
+
+            if (first.db->Assembly.size())
+            {
+                remap_row(first, table_id::Assembly, 0, values);
+                values[4] = m_writer.strings().add(m_name);
+                first.rows[static_cast<uint8_t>(table_id::Assembly)][0] = m_writer.add_row(table_id::Assembly, values);
+            }
+
+            std::array<uint32_t, table_count> counts{};
+
+            for (auto&& s : m_sources)
+            {
+                // AssemblyRefs are added as they are referenced, so that those only used by
+                // references resolved within the merged module are left out.
+                auto& module_refs = s.rows[static_cast<uint8_t>(table_id::ModuleRef)];
+
+                for (uint32_t row{}; row < module_refs.size(); ++row)
+                {
+                    remap_row(s, table_id::ModuleRef, row, values);
+                    module_refs[row] = add_unique_row(table_id::ModuleRef, values);
+                }
+
+                for (auto&& table : concatenated_tables)
+                {
+                    auto const id = static_cast<uint8_t>(table);
+                    auto const& keep = s.keep[id];
+                    auto& rows = s.rows[id];
+                    auto& lists = s.lists[id];
+                    lists.resize(rows.size() + 1);
+
+                    for (uint32_t row{}; row < rows.size(); ++row)
+                    {
+                        if (keep[row])
+                        {
+                            rows[row] = ++counts[id];
+                        }
+                    }
+
+                    lists.back() = counts[id] + 1;
+
+                    for (auto row = static_cast<uint32_t>(rows.size()); row--;)
+                    {
+                        lists[row] = keep[row] ? rows[row] : lists[row + 1];
+                    }
+                }
+            }
+
+            for (auto&& table : concatenated_tables)
+            {
+                m_writer.resize(table, counts[static_cast<uint8_t>(table)]);
+            }
+        }
+
+        void write_rows()
+        {
+            row_values values;
+
+            for (auto&& s : m_sources)
+            {
+                for (auto&& table : concatenated_tables)
+                {
+                    auto const& rows = s.rows[static_cast<uint8_t>(table)];
+
+                    for (uint32_t row{}; row < rows.size(); ++row)
+                    {
+                        if (!rows[row])
+                        {
+                            continue;
+                        }
+
+                        [[maybe_unused]] auto const complete = remap_row(s, table, row, values);
+                        XLANG_ASSERT(complete);
+                        m_writer.set_row(table, rows[row], values);
+                    }
+                }
+            }
+        }
+
+        void write_sorted_rows()
+        {
+            row_values values;
+
+            for (auto&& [table, key, secondary] : sorted_tables)
+            {
+                auto const id = static_cast<uint8_t>(table);
+
+                for (auto&& s : m_sources)
+                {
+                    auto& rows = s.rows[id];
+
+                    for (uint32_t row{}; row < rows.size(); ++row)
+                    {
+                        if (remap_row(s, table, row, values))
+                        {
+                            rows[row] = m_writer.add_row(table, values);
+                        }
+                    }
+                }
+
+                auto const remap = m_writer.sort(table, key, secondary);
+
+                for (auto&& s : m_sources)
+                {
+                    for (auto&& row : s.rows[id])
+                    {
+                        if (row)
+                        {
+                            row = remap[row - 1];
+                        }
+                    }
+                }
+            }
+        }
+
+        uint32_t add_unique_row(table_id const table, row_values const& values)
+        {
+            auto [pos, added] = m_unique_rows.try_emplace({ table, values }, 0);
+
+            if (added)
+            {
+                pos->second = m_writer.add_row(table, values);
+            }
+
+            return pos->second;
+        }
+
+        // Returns false if the row refers to a row that is left out, in which case it is left out too.
+        bool remap_row(source& s, table_id const table, uint32_t const row, row_values& values)
+        {
+            auto const schema = get_table_schema(table);
+            auto const& rows = get_table(*s.db, table);
+
+            // References are remapped first so that a row that is left out does not add to the heaps.
+            for (auto pass : { true, false })
+            {
+                for (uint32_t column{}; column < schema.column_count; ++column)
+                {
+                    auto const& type = schema.columns[column];
+                    auto const reference = type.type == column_type::index || type.type == column_type::list || type.type == column_type::coded;
+
+                    if (reference != pass)
+                    {
+                        continue;
+                    }
+
+                    auto const value = rows.get_value<uint64_t>(row, column);
+                    values[column] = remap(s, type, value);
+
+                    if (value && !values[column] && reference)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        uint64_t remap(source& s, column_schema const& column, uint64_t const value)
+        {
+            auto const& db = *s.db;
+
+            switch (column.type)
+            {
+            case column_type::constant:
+                return value;
+            case column_type::string:
+                return m_writer.strings().add(db.get_string(static_cast<uint32_t>(value)));
+            case column_type::guid:
+                return value ? m_writer.guids().add(db.get_guid(static_cast<uint32_t>(value)).begin()) : 0;
+            case column_type::blob:
+                if (value)
+                {
+                    auto const blob = db.get_blob(static_cast<uint32_t>(value));
+                    return m_writer.blobs().add(blob.begin(), blob.size());
+                }
+                return 0;
+            case column_type::signature:
+                return add_signature(s, static_cast<uint32_t>(value), false);
+            case column_type::type_signature:
+                return add_signature(s, static_cast<uint32_t>(value), true);
+            case column_type::index:
+                return value ? s.rows[static_cast<uint8_t>(column.table())][value - 1] : 0;
+            case column_type::list:
+                return s.lists[static_cast<uint8_t>(column.table())][value - 1];
+            case column_type::coded:
+                return remap_coded(s, column.coded_index(), static_cast<uint32_t>(value));
+            }
+
+            return 0;
+        }
+
+        uint32_t remap_coded(source& s, coded_index_id const id, uint32_t const value)
+        {
+            if (!value)
+            {
+                return 0;
+            }
+
+            auto const& schema = get_coded_index_schema(id);
+            auto const [table, row] = decode(id, value);
+
+            // Every source module becomes part of the merged module.
+            if (table == table_id::Module && id == coded_index_id::ResolutionScope)
+            {
+                return schema.encode(table, 1);
+            }
+
+            if (table == table_id::TypeRef && (id == coded_index_id::TypeDefOrRef || id == coded_index_id::MemberRefParent))
+            {
+                if (auto const [index, original] = s.ref_definitions[row]; index)
+                {
+                    return schema.encode(table_id::TypeDef, m_sources[index - 1].rows[static_cast<uint8_t>(table_id::TypeDef)][original]);
+                }
+            }
+
+            if (table == table_id::MemberRef)
+            {
+                if (auto const& member = s.member_definitions[row]; member.source)
+                {
+                    if (member.table == table_id::MethodDef && (id == coded_index_id::MethodDefOrRef || id == coded_index_id::CustomAttributeType))
+                    {
+                        return schema.encode(table_id::MethodDef, m_sources[member.source - 1].rows[static_cast<uint8_t>(table_id::MethodDef)][member.row]);
+                    }
+
+                    return 0;
+                }
+            }
+
+            // References are written when first needed. Attributes on a reference don't need it.
+            if (table == table_id::TypeRef || table == table_id::MemberRef || table == table_id::TypeSpec || table == table_id::AssemblyRef)
+            {
+                auto const result = id == coded_index_id::HasCustomAttribute ? s.rows[static_cast<uint8_t>(table)][row] : add_reference(s, table, row);
+                return result ? schema.encode(table, result) : 0;
+            }
+
+            if (auto const result = s.rows[static_cast<uint8_t>(table)][row])
+            {
+                return schema.encode(table, result);
+            }
+
+            if (table == table_id::TypeDef && (id == coded_index_id::TypeDefOrRef || id == coded_index_id::MemberRefParent))
+            {
+                return reference_type(s, schema, row);
+            }
+
+            if (table == table_id::MethodDef && (id == coded_index_id::MethodDefOrRef || id == coded_index_id::CustomAttributeType))
+            {
+                return schema.encode(table_id::MemberRef, member_ref(s, row));
+            }
+
+            if (table == table_id::MethodDef && id == coded_index_id::MemberRefParent)
+            {
+                return reference_type(s, schema, s.method_owner[row]);
+            }
+
+            return 0;
+        }
+
+        uint32_t reference_type(source& s, coded_index_schema const& schema, uint32_t const row)
+        {
+            if (auto const result = s.rows[static_cast<uint8_t>(table_id::TypeDef)][row])
+            {
+                return schema.encode(table_id::TypeDef, result);
+            }
+
+            if (auto const [index, original] = s.duplicates[row]; index)
+            {
+                return schema.encode(table_id::TypeDef, m_sources[index - 1].rows[static_cast<uint8_t>(table_id::TypeDef)][original]);
+            }
+
+            return schema.encode(table_id::TypeRef, type_ref(s, row));
+        }
+
+        uint32_t type_ref(source& s, uint32_t const row)
+        {
+            if (s.type_refs[row])
+            {
+                return s.type_refs[row];
+            }
+
+            auto const& schema = get_coded_index_schema(coded_index_id::ResolutionScope);
+            auto const scope = s.enclosing[row] ?
+                schema.encode(table_id::TypeRef, type_ref(s, s.enclosing[row] - 1)) :
+                schema.encode(table_id::AssemblyRef, assembly_ref(s));
+
+            reader::TypeDef const type{ &s.db->TypeDef, row };
+            s.type_refs[row] = m_writer.add_row(table_id::TypeRef, { scope, m_writer.strings().add(type.TypeName()), m_writer.strings().add(type.TypeNamespace()) });
+            return s.type_refs[row];
+        }
+
+        uint32_t member_ref(source& s, uint32_t const row)
+        {
+            if (s.member_refs[row])
+            {
+                return s.member_refs[row];
+            }
+
+            auto const& db = *s.db;
+            auto const parent = reference_type(s, get_coded_index_schema(coded_index_id::MemberRefParent), s.method_owner[row]);
+            auto const name = m_writer.strings().add(db.get_string(get_value(db, table_id::MethodDef, row, 3)));
+            auto const signature = add_signature(s, get_value(db, table_id::MethodDef, row, 4), false);
+            s.member_refs[row] = m_writer.add_row(table_id::MemberRef, { parent, name, signature });
+            return s.member_refs[row];
+        }
+
+        // Returns the new row of a reference, writing it if this is the first time it is needed, or
+        // zero if it refers to a row that is left out.
+        uint32_t add_reference(source& s, table_id const table, uint32_t const row)
+        {
+            if (auto const result = s.rows[static_cast<uint8_t>(table)][row])
+            {
+                return result;
+            }
+
+            row_values values;
+
+            if (!remap_row(s, table, row, values))
+            {
+                return 0;
+            }
+
+            auto const result = table == table_id::AssemblyRef ? add_unique_row(table, values) : m_writer.add_row(table, values);
+            s.rows[static_cast<uint8_t>(table)][row] = result;
+            return result;
+        }
+
+        uint32_t assembly_ref(source& s)
+        {
+            if (s.assembly_ref)
+            {
+                return s.assembly_ref;
+            }
+
+            auto const& db = *s.db;
+
+            if (!db.Assembly.size())
+            {
+                throw_invalid("Database '", db.path(), "' has no assembly to refer to");
+            }
+
+            row_values values{};
+            remap_row(s, table_id::Assembly, 0, values);
+
+            s.assembly_ref = add_unique_row(table_id::AssemblyRef,
+            {
+                values[1],          // Version
+                values[2] & 0x0001, // PublicKey flag
+                values[3],          // PublicKeyOrToken
+                values[4],          // Name
+                values[5],          // Culture
+                0,                  // HashValue
+            });
+
+            return s.assembly_ref;
+        }
+
+        // Copies a signature blob, remapping the TypeDefOrRef tokens it contains.
+        uint32_t add_signature(source& s, uint32_t const index, bool const type)
+        {
+            if (!index)
+            {
+                return 0;
+            }
+
+            return m_writer.blobs().add(copy_blob(s, index, type, [&](reader::byte_view& cursor, std::vector<uint8_t>& output)
+            {
+                compress_unsigned(output, remap_coded(s, coded_index_id::TypeDefOrRef, reader::uncompress_unsigned(cursor)));
+            }));
+        }
+
+        // Returns a signature blob with each TypeDefOrRef token replaced by the full name of the type,
+        // so that signatures from different sources can be compared.
+        std::vector<uint8_t> get_canonical_signature(source const& s, uint32_t const index, bool const type) const
+        {
+            if (!index)
+            {
+                return {};
+            }
+
+            return copy_blob(s, index, type, [&](reader::byte_view& cursor, std::vector<uint8_t>& output)
+            {
+                auto const value = reader::uncompress_unsigned(cursor);
+
+                if (!(value >> 2))
+                {
+                    output.push_back(0);
+                    return;
+                }
+
+                auto const [table, row] = decode(coded_index_id::TypeDefOrRef, value);
+
+                if (table == table_id::TypeSpec)
+                {
+                    auto const spec = get_canonical_signature(s, get_value(*s.db, table_id::TypeSpec, row, 0), true);
+                    output.push_back(2);
+                    compress_unsigned(output, static_cast<uint32_t>(spec.size()));
+                    output.insert(output.end(), spec.begin(), spec.end());
+                    return;
+                }
+
+                auto const& name = table == table_id::TypeDef ? s.type_names[row] : s.ref_names[row];
+                output.push_back(1);
+                compress_unsigned(output, static_cast<uint32_t>(name.size()));
+                output.insert(output.end(), name.begin(), name.end());
+            });
+        }
+
+        template <typename F>
+        static std::vector<uint8_t> copy_blob(source const& s, uint32_t const index, bool const type, F&& token)
+        {
+            auto cursor = s.db->get_blob(index);
+            std::vector<uint8_t> output;
+            output.reserve(cursor.size());
+
+            if (type)
+            {
+                copy_type(cursor, output, token);
+            }
+            else
+            {
+                copy_signature(cursor, output, token);
+            }
+
+            output.insert(output.end(), cursor.begin(), cursor.end());
+            return output;
+        }
+
+        static uint8_t copy_byte(reader::byte_view& cursor, std::vector<uint8_t>& output)
+        {
+            auto const value = cursor.as<uint8_t>();
+            output.push_back(value);
+            cursor = cursor.seek(1);
+            return value;
+        }
+
+        // Copies a compressed integer as is, since signed values depend on their encoded width.
+        static uint32_t copy_compressed(reader::byte_view& cursor, std::vector<uint8_t>& output)
+        {
+            auto const first = cursor.as<uint8_t>();
+            uint32_t const size = (first & 0x80) == 0 ? 1 : (first & 0xc0) == 0x80 ? 2 : 4;
+            auto const bytes = cursor.sub(0, size);
+            output.insert(output.end(), bytes.begin(), bytes.end());
+            cursor = cursor.seek(size);
+            auto value = bytes;
+            return reader::uncompress_unsigned(value);
+        }
+
+        template <typename F>
+        static void copy_signature(reader::byte_view& cursor, std::vector<uint8_t>& output, F const& token)
+        {
+            switch (cursor.as<uint8_t>() & 0x0f)
+            {
+            case 0x06: // FIELD
+                copy_byte(cursor, output);
+                copy_type(cursor, output, token);
+                break;
+            case 0x07: // LOCAL_SIG
+            case 0x0a: // GENERICINST
+                copy_byte(cursor, output);
+                for (auto count = copy_compressed(cursor, output); count; --count)
+                {
+                    copy_type(cursor, output, token);
+                }
+                break;
+            case 0x08: // PROPERTY
+                copy_byte(cursor, output);
+                for (auto count = copy_compressed(cursor, output) + 1; count; --count)
+                {
+                    copy_type(cursor, output, token);
+                }
+                break;
+            default:
+                copy_method(cursor, output, token);
+                break;
+            }
+        }
+
+        template <typename F>
+        static void copy_method(reader::byte_view& cursor, std::vector<uint8_t>& output, F const& token)
+        {
+            if (copy_byte(cursor, output) & 0x10) // GENERIC
+            {
+                copy_compressed(cursor, output);
+            }
+
+            for (auto count = copy_compressed(cursor, output) + 1; count; --count)
+            {
+                copy_type(cursor, output, token);
+            }
+        }
+
+        template <typename F>
+        static void copy_type(reader::byte_view& cursor, std::vector<uint8_t>& output, F const& token)
+        {
+            while (true)
+            {
+                auto const element = copy_byte(cursor, output);
+
+                switch (element)
+                {
+                case 0x1f: // CMOD_REQD
+                case 0x20: // CMOD_OPT
+                    token(cursor, output);
+                    continue;
+                case 0x0f: // PTR
+                case 0x10: // BYREF
+                case 0x1d: // SZARRAY
+                case 0x41: // SENTINEL
+                case 0x45: // PINNED
+                    continue;
+                case 0x11: // VALUETYPE
+                case 0x12: // CLASS
+                    token(cursor, output);
+                    return;
+                case 0x13: // VAR
+                case 0x1e: // MVAR
+                    copy_compressed(cursor, output);
+                    return;
+                case 0x14: // ARRAY
+                    copy_type(cursor, output, token);
+                    copy_compressed(cursor, output);
+                    for (auto count = copy_compressed(cursor, output); count; --count)
+                    {
+                        copy_compressed(cursor, output);
+                    }
+                    for (auto count = copy_compressed(cursor, output); count; --count)
+                    {
+                        copy_compressed(cursor, output);
+                    }
+                    return;
+                case 0x15: // GENERICINST
+                    copy_byte(cursor, output);
+                    token(cursor, output);
+                    for (auto count = copy_compressed(cursor, output); count; --count)
+                    {
+                        copy_type(cursor, output, token);
+                    }
+                    return;
+                case 0x1b: // FNPTR
+                    copy_method(cursor, output, token);
+                    return;
+                }
+
+                if ((element >= 0x01 && element <= 0x0e) || element == 0x16 || element == 0x18 || element == 0x19 || element == 0x1c)
+                {
+                    return;
+                }
+
+                throw_invalid("Unsupported signature element type");
+            }
+        }
+
+        std::string m_name;
+        std::function<bool(reader::TypeDef const&)> m_filter;
+        std::vector<source> m_sources;
+        std::map<std::pair<table_id, row_values>, uint32_t> m_unique_rows;
+        metadata_writer m_writer;
+        bool m_merged{};
+    };
+}
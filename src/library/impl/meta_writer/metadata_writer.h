@@ -0,0 +1,566 @@
+#pragma once
+
+#include "heaps.h"
+#include "pe_writer.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace xlang::meta::writer
+{
+    enum class table_id : uint8_t
+    {
+        Module = 0x00,
+        TypeRef = 0x01,
+        TypeDef = 0x02,
+        Field = 0x04,
+        MethodDef = 0x06,
+        Param = 0x08,
+        InterfaceImpl = 0x09,
+        MemberRef = 0x0a,
+        Constant = 0x0b,
+        CustomAttribute = 0x0c,
+        FieldMarshal = 0x0d,
+        DeclSecurity = 0x0e,
+        ClassLayout = 0x0f,
+        FieldLayout = 0x10,
+        StandAloneSig = 0x11,
+        EventMap = 0x12,
+        Event = 0x14,
+        PropertyMap = 0x15,
+        Property = 0x17,
+        MethodSemantics = 0x18,
+        MethodImpl = 0x19,
+        ModuleRef = 0x1a,
+        TypeSpec = 0x1b,
+        ImplMap = 0x1c,
+        FieldRVA = 0x1d,
+        Assembly = 0x20,
+        AssemblyProcessor = 0x21,
+        AssemblyOS = 0x22,
+        AssemblyRef = 0x23,
+        AssemblyRefProcessor = 0x24,
+        AssemblyRefOS = 0x25,
+        File = 0x26,
+        ExportedType = 0x27,
+        ManifestResource = 0x28,
+        NestedClass = 0x29,
+        GenericParam = 0x2a,
+        MethodSpec = 0x2b,
+        GenericParamConstraint = 0x2c,
+    };
+
+    inline constexpr uint32_t table_count{ 64 };
+
+    enum class coded_index_id : uint8_t
+    {
+        TypeDefOrRef,
+        HasConstant,
+        HasCustomAttribute,
+        HasFieldMarshal,
+        HasDeclSecurity,
+        MemberRefParent,
+        HasSemantics,
+        MethodDefOrRef,
+        MemberForwarded,
+        Implementation,
+        CustomAttributeType,
+        ResolutionScope,
+        TypeOrMethodDef,
+    };
+
+    struct coded_index_schema
+    {
+        // Tables in tag order. Tags that ECMA-335 reserves but does not use are 0xff.
+        std::array<uint8_t, 22> tables;
+        uint8_t count;
+        uint8_t bits;
+
+        uint32_t tag(table_id const table) const
+        {
+            for (uint8_t tag{}; tag < count; ++tag)
+            {
+                if (tables[tag] == static_cast<uint8_t>(table))
+                {
+                    return tag;
+                }
+            }
+
+            throw_invalid("Table cannot be referenced by this coded index");
+        }
+
+        uint32_t encode(table_id const table, uint32_t const row) const
+        {
+            return (row << bits) | tag(table);
+        }
+    };
+
+    inline coded_index_schema const& get_coded_index_schema(coded_index_id const id) noexcept
+    {
+        static constexpr uint8_t unused{ 0xff };
+
+        static constexpr std::array<coded_index_schema, 13> schemas
+        { {
+            { { 0x02, 0x01, 0x1b }, 3, 2 },
+            { { 0x04, 0x08, 0x17 }, 3, 2 },
+            { { 0x06, 0x04, 0x01, 0x02, 0x08, 0x09, 0x0a, 0x00, 0x0e, 0x17, 0x14, 0x11, 0x1a, 0x1b, 0x20, 0x23, 0x26, 0x27, 0x28, 0x2a, 0x2c, 0x2b }, 22, 5 },
+            { { 0x04, 0x08 }, 2, 1 },
+            { { 0x02, 0x06, 0x20 }, 3, 2 },
+            { { 0x02, 0x01, 0x1a, 0x06, 0x1b }, 5, 3 },
+            { { 0x14, 0x17 }, 2, 1 },
+            { { 0x06, 0x0a }, 2, 1 },
+            { { 0x04, 0x06 }, 2, 1 },
+            { { 0x26, 0x23, 0x27 }, 3, 2 },
+            { { unused, unused, 0x06, 0x0a, unused }, 5, 3 },
+            { { 0x00, 0x1a, 0x23, 0x01 }, 4, 2 },
+            { { 0x02, 0x06 }, 2, 1 },
+        } };
+
+        return schemas[static_cast<uint8_t>(id)];
+    }
+
+    enum class column_type : uint8_t
+    {
+        constant,       // Fixed-size value of the given width
+        string,         // #Strings offset
+        guid,           // #GUID index
+        blob,           // #Blob offset
+        signature,      // #Blob offset of a field, method, property, local variable or method spec signature
+        type_signature, // #Blob offset of a TypeSpec signature
+        index,          // Row of the given table
+        list,           // First row of a run in the given table
+        coded,          // Coded index of the given kind
+    };
+
+    struct column_schema
+    {
+        column_type type;
+        uint8_t value;
+
+        static constexpr column_schema constant(uint8_t const size) noexcept
+        {
+            return { column_type::constant, size };
+        }
+
+        static constexpr column_schema heap(column_type const type) noexcept
+        {
+            return { type, 0 };
+        }
+
+        static constexpr column_schema index(table_id const table) noexcept
+        {
+            return { column_type::index, static_cast<uint8_t>(table) };
+        }
+
+        static constexpr column_schema list(table_id const table) noexcept
+        {
+            return { column_type::list, static_cast<uint8_t>(table) };
+        }
+
+        static constexpr column_schema coded(coded_index_id const id) noexcept
+        {
+            return { column_type::coded, static_cast<uint8_t>(id) };
+        }
+
+        table_id table() const noexcept
+        {
+            XLANG_ASSERT(type == column_type::index || type == column_type::list);
+            return static_cast<table_id>(value);
+        }
+
+        coded_index_id coded_index() const noexcept
+        {
+            XLANG_ASSERT(type == column_type::coded);
+            return static_cast<coded_index_id>(value);
+        }
+    };
+
+    struct table_schema
+    {
+        uint8_t column_count;
+        std::array<column_schema, 6> columns;
+    };
+
+    // Mirrors the column layouts that reader::database reads.
+    inline table_schema get_table_schema(table_id const table) noexcept
+    {
+        using c = column_schema;
+        auto const string = c::heap(column_type::string);
+        auto const guid = c::heap(column_type::guid);
+        auto const blob = c::heap(column_type::blob);
+        auto const signature = c::heap(column_type::signature);
+
+        switch (table)
+        {
+        case table_id::Module: return { 5, { c::constant(2), string, guid, guid, guid } };
+        case table_id::TypeRef: return { 3, { c::coded(coded_index_id::ResolutionScope), string, string } };
+        case table_id::TypeDef: return { 6, { c::constant(4), string, string, c::coded(coded_index_id::TypeDefOrRef), c::list(table_id::Field), c::list(table_id::MethodDef) } };
+        case table_id::Field: return { 3, { c::constant(2), string, signature } };
+        case table_id::MethodDef: return { 6, { c::constant(4), c::constant(2), c::constant(2), string, signature, c::list(table_id::Param) } };
+        case table_id::Param: return { 3, { c::constant(2), c::constant(2), string } };
+        case table_id::InterfaceImpl: return { 2, { c::index(table_id::TypeDef), c::coded(coded_index_id::TypeDefOrRef) } };
+        case table_id::MemberRef: return { 3, { c::coded(coded_index_id::MemberRefParent), string, signature } };
+        case table_id::Constant: return { 3, { c::constant(2), c::coded(coded_index_id::HasConstant), blob } };
+        case table_id::CustomAttribute: return { 3, { c::coded(coded_index_id::HasCustomAttribute), c::coded(coded_index_id::CustomAttributeType), blob } };
+        case table_id::FieldMarshal: return { 2, { c::coded(coded_index_id::HasFieldMarshal), blob } };
+        case table_id::DeclSecurity: return { 3, { c::constant(2), c::coded(coded_index_id::HasDeclSecurity), blob } };
+        case table_id::ClassLayout: return { 3, { c::constant(2), c::constant(4), c::index(table_id::TypeDef) } };
+        case table_id::FieldLayout: return { 2, { c::constant(4), c::index(table_id::Field) } };
+        case table_id::StandAloneSig: return { 1, { signature } };
+        case table_id::EventMap: return { 2, { c::index(table_id::TypeDef), c::list(table_id::Event) } };
+        case table_id::Event: return { 3, { c::constant(2), string, c::coded(coded_index_id::TypeDefOrRef) } };
+        case table_id::PropertyMap: return { 2, { c::index(table_id::TypeDef), c::list(table_id::Property) } };
+        case table_id::Property: return { 3, { c::constant(2), string, signature } };
+        case table_id::MethodSemantics: return { 3, { c::constant(2), c::index(table_id::MethodDef), c::coded(coded_index_id::HasSemantics) } };
+        case table_id::MethodImpl: return { 3, { c::index(table_id::TypeDef), c::coded(coded_index_id::MethodDefOrRef), c::coded(coded_index_id::MethodDefOrRef) } };
+        case table_id::ModuleRef: return { 1, { string } };
+        case table_id::TypeSpec: return { 1, { c::heap(column_type::type_signature) } };
+        case table_id::ImplMap: return { 4, { c::constant(2), c::coded(coded_index_id::MemberForwarded), string, c::index(table_id::ModuleRef) } };
+        case table_id::FieldRVA: return { 2, { c::constant(4), c::index(table_id::Field) } };
+        case table_id::Assembly: return { 6, { c::constant(4), c::constant(8), c::constant(4), blob, string, string } };
+        case table_id::AssemblyProcessor: return { 1, { c::constant(4) } };
+        case table_id::AssemblyOS: return { 3, { c::constant(4), c::constant(4), c::constant(4) } };
+        case table_id::AssemblyRef: return { 6, { c::constant(8), c::constant(4), blob, string, string, blob } };
+        case table_id::AssemblyRefProcessor: return { 2, { c::constant(4), c::index(table_id::AssemblyRef) } };
+        case table_id::AssemblyRefOS: return { 4, { c::constant(4), c::constant(4), c::constant(4), c::index(table_id::AssemblyRef) } };
+        case table_id::File: return { 3, { c::constant(4), string, blob } };
+        case table_id::ExportedType: return { 5, { c::constant(4), c::constant(4), string, string, c::coded(coded_index_id::Implementation) } };
+        case table_id::ManifestResource: return { 4, { c::constant(4), c::constant(4), string, c::coded(coded_index_id::Implementation) } };
+        case table_id::NestedClass: return { 2, { c::index(table_id::TypeDef), c::index(table_id::TypeDef) } };
+        case table_id::GenericParam: return { 4, { c::constant(2), c::constant(2), c::coded(coded_index_id::TypeOrMethodDef), string } };
+        case table_id::MethodSpec: return { 2, { c::coded(coded_index_id::MethodDefOrRef), signature } };
+        case table_id::GenericParamConstraint: return { 2, { c::index(table_id::GenericParam), c::coded(coded_index_id::TypeDefOrRef) } };
+        }
+
+        return {};
+    }
+
+    // Builds the metadata of a module: the #~ table stream and the heaps it refers to. Rows hold
+    // unencoded values, one-based row indexes and ECMA-335 coded indexes, so the width of every
+    // column is only decided when the metadata is saved and the table and heap sizes are known.
+    struct metadata_writer
+    {
+        string_heap& strings() noexcept
+        {
+            return m_strings;
+        }
+
+        blob_heap& blobs() noexcept
+        {
+            return m_blobs;
+        }
+
+        guid_heap& guids() noexcept
+        {
+            return m_guids;
+        }
+
+        void version(std::string_view const& value)
+        {
+            m_version = value;
+        }
+
+        uint32_t size(table_id const table) const noexcept
+        {
+            return static_cast<uint32_t>(m_tables[static_cast<uint8_t>(table)].size() / column_count(table));
+        }
+
+        // Reserves rows to be filled in later with set_row, so that rows can be added in a different
+        // order than they will appear in the table.
+        void resize(table_id const table, uint32_t const rows)
+        {
+            m_tables[static_cast<uint8_t>(table)].resize(std::size_t{ rows } * column_count(table));
+        }
+
+        // Returns the one-based index of the new row.
+        uint32_t add_row(table_id const table, std::initializer_list<uint64_t> const values)
+        {
+            XLANG_ASSERT(values.size() == column_count(table));
+            auto& rows = m_tables[static_cast<uint8_t>(table)];
+            rows.insert(rows.end(), values.begin(), values.end());
+            return size(table);
+        }
+
+        template <typename Values>
+        uint32_t add_row(table_id const table, Values const& values)
+        {
+            resize(table, size(table) + 1);
+            set_row(table, size(table), values);
+            return size(table);
+        }
+
+        template <typename Values>
+        void set_row(table_id const table, uint32_t const row, Values const& values)
+        {
+            XLANG_ASSERT(row && row <= size(table));
+            auto const count = column_count(table);
+            std::copy_n(std::begin(values), count, m_tables[static_cast<uint8_t>(table)].begin() + std::size_t{ row - 1 } * count);
+        }
+
+        uint64_t get_value(table_id const table, uint32_t const row, uint32_t const column) const noexcept
+        {
+            XLANG_ASSERT(row && row <= size(table));
+            return m_tables[static_cast<uint8_t>(table)][std::size_t{ row - 1 } * column_count(table) + column];
+        }
+
+        // Stably sorts the rows of a table by one or two key columns and marks the table as sorted.
+        // Returns the new index of each row, indexed by its old index minus one, so that references
+        // to the table can be updated.
+        std::vector<uint32_t> sort(table_id const table, uint32_t const key, std::optional<uint32_t> const secondary = {})
+        {
+            auto const count = column_count(table);
+            auto& rows = m_tables[static_cast<uint8_t>(table)];
+            std::vector<uint32_t> order(size(table));
+            std::iota(order.begin(), order.end(), 0);
+
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t const left, uint32_t const right)
+            {
+                auto const left_row = rows.begin() + std::size_t{ left } * count;
+                auto const right_row = rows.begin() + std::size_t{ right } * count;
+
+                if (left_row[key] != right_row[key] || !secondary)
+                {
+                    return left_row[key] < right_row[key];
+                }
+
+                return left_row[*secondary] < right_row[*secondary];
+            });
+
+            std::vector<uint64_t> sorted;
+            sorted.reserve(rows.size());
+            std::vector<uint32_t> remap(order.size());
+
+            for (uint32_t row{}; row < order.size(); ++row)
+            {
+                auto const first = rows.begin() + std::size_t{ order[row] } * count;
+                sorted.insert(sorted.end(), first, first + count);
+                remap[order[row]] = row + 1;
+            }
+
+            rows.swap(sorted);
+            m_sorted |= 1ull << static_cast<uint8_t>(table);
+            return remap;
+        }
+
+        // Returns the metadata root and its streams, ready for pe_writer::add_metadata.
+        std::vector<uint8_t> save() const
+        {
+            auto const strings = padded_size(m_strings.data());
+            auto const user_strings = uint32_t{ 4 };
+            auto const guids = padded_size(m_guids.data());
+            auto const blobs = padded_size(m_blobs.data());
+            auto const tables = save_tables();
+
+            struct stream
+            {
+                std::string_view name;
+                uint8_t const* data;
+                uint32_t size;
+                uint32_t padded_size;
+            };
+
+            static constexpr uint8_t empty_user_strings[4]{};
+
+            std::array<stream, 5> const streams
+            { {
+                { "#~", tables.data(), static_cast<uint32_t>(tables.size()), static_cast<uint32_t>(tables.size()) },
+                { "#Strings", m_strings.data().data(), static_cast<uint32_t>(m_strings.data().size()), strings },
+                { "#US", empty_user_strings, user_strings, user_strings },
+                { "#GUID", m_guids.data().data(), static_cast<uint32_t>(m_guids.data().size()), guids },
+                { "#Blob", m_blobs.data().data(), static_cast<uint32_t>(m_blobs.data().size()), blobs },
+            } };
+
+            auto const version_size = round_up(static_cast<uint32_t>(m_version.size() + 1), 4);
+            uint32_t offset = 20 + version_size;
+
+            for (auto&& stream : streams)
+            {
+                offset += 8 + round_up(static_cast<uint32_t>(stream.name.size() + 1), 4);
+            }
+
+            std::vector<uint8_t> output;
+            output.reserve(offset + tables.size() + strings + user_strings + guids + blobs);
+
+            write(output, uint32_t{ 0x424a5342 });
+            write(output, uint16_t{ 1 });
+            write(output, uint16_t{ 1 });
+            write(output, uint32_t{ 0 });
+            write(output, version_size);
+            output.insert(output.end(), m_version.begin(), m_version.end());
+            output.resize(output.size() + version_size - m_version.size());
+            write(output, uint16_t{ 0 });
+            write(output, static_cast<uint16_t>(streams.size()));
+
+            for (auto&& stream : streams)
+            {
+                write(output, offset);
+                write(output, stream.padded_size);
+                output.insert(output.end(), stream.name.begin(), stream.name.end());
+                output.resize(output.size() + round_up(static_cast<uint32_t>(stream.name.size() + 1), 4) - stream.name.size());
+                offset += stream.padded_size;
+            }
+
+            for (auto&& stream : streams)
+            {
+                output.insert(output.end(), stream.data, stream.data + stream.size);
+                output.resize(output.size() + stream.padded_size - stream.size);
+            }
+
+            return output;
+        }
+
+        void save_to_file(std::filesystem::path const& path) const
+        {
+            pe_writer writer;
+            writer.add_metadata(save());
+            writer.save_to_file(path);
+        }
+
+    private:
+
+        static uint32_t column_count(table_id const table) noexcept
+        {
+            return get_table_schema(table).column_count;
+        }
+
+        static uint32_t round_up(uint32_t const size, uint32_t const alignment) noexcept
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+        static uint32_t padded_size(std::vector<uint8_t> const& heap) noexcept
+        {
+            return round_up(static_cast<uint32_t>(heap.size()), 4);
+        }
+
+        template <typename T>
+        static void write(std::vector<uint8_t>& output, T const value)
+        {
+            auto const first = reinterpret_cast<uint8_t const*>(&value);
+            output.insert(output.end(), first, first + sizeof(T));
+        }
+
+        // Lays out the #~ stream in a single pass over a buffer sized up front.
+        std::vector<uint8_t> save_tables() const
+        {
+            uint8_t const string_size = m_strings.data().size() < 0x10000 ? 2 : 4;
+            uint8_t const guid_size = m_guids.data().size() < 0x10000 ? 2 : 4;
+            uint8_t const blob_size = m_blobs.data().size() < 0x10000 ? 2 : 4;
+
+            auto column_size = [&](column_schema const& column) -> uint8_t
+            {
+                switch (column.type)
+                {
+                case column_type::constant:
+                    return column.value;
+                case column_type::string:
+                    return string_size;
+                case column_type::guid:
+                    return guid_size;
+                case column_type::blob:
+                case column_type::signature:
+                case column_type::type_signature:
+                    return blob_size;
+                case column_type::index:
+                case column_type::list:
+                    return size(column.table()) < 0x10000 ? 2 : 4;
+                case column_type::coded:
+                    break;
+                }
+
+                auto const& schema = get_coded_index_schema(column.coded_index());
+
+                for (uint8_t tag{}; tag < schema.count; ++tag)
+                {
+                    if (schema.tables[tag] != 0xff && size(static_cast<table_id>(schema.tables[tag])) >= (1u << (16 - schema.bits)))
+                    {
+                        return 4;
+                    }
+                }
+
+                return 2;
+            };
+
+            uint64_t valid{};
+            std::size_t total{ 24 };
+            std::array<std::array<uint8_t, 6>, table_count> column_sizes{};
+
+            for (uint8_t table{}; table < table_count; ++table)
+            {
+                if (m_tables[table].empty())
+                {
+                    continue;
+                }
+
+                auto const id = static_cast<table_id>(table);
+                auto const schema = get_table_schema(id);
+                std::size_t row_size{};
+
+                for (uint8_t column{}; column < schema.column_count; ++column)
+                {
+                    column_sizes[table][column] = column_size(schema.columns[column]);
+                    row_size += column_sizes[table][column];
+                }
+
+                valid |= 1ull << table;
+                total += 4 + row_size * size(id);
+            }
+
+            std::vector<uint8_t> output(round_up(static_cast<uint32_t>(total), 4));
+            auto cursor = output.data();
+
+            auto put = [&](uint64_t const value, uint8_t const bytes)
+            {
+                XLANG_ASSERT(bytes == 8 || value < (1ull << (bytes * 8)));
+                std::memcpy(cursor, &value, bytes);
+                cursor += bytes;
+            };
+
+            put(0, 4);
+            put(2, 1);
+            put(0, 1);
+            put((string_size == 4 ? 1 : 0) | (guid_size == 4 ? 2 : 0) | (blob_size == 4 ? 4 : 0), 1);
+            put(1, 1);
+            put(valid, 8);
+            put(m_sorted & valid, 8);
+
+            for (uint8_t table{}; table < table_count; ++table)
+            {
+                if (valid & (1ull << table))
+                {
+                    put(size(static_cast<table_id>(table)), 4);
+                }
+            }
+
+            for (uint8_t table{}; table < table_count; ++table)
+            {
+                if (!(valid & (1ull << table)))
+                {
+                    continue;
+                }
+
+                auto const count = column_count(static_cast<table_id>(table));
+                auto const& sizes = column_sizes[table];
+                auto const& rows = m_tables[table];
+
+                for (std::size_t value{}; value < rows.size(); value += count)
+                {
+                    for (uint32_t column{}; column < count; ++column)
+                    {
+                        put(rows[value + column], sizes[column]);
+                    }
+                }
+            }
+
+            XLANG_ASSERT(static_cast<std::size_t>(cursor - output.data()) == total);
+            return output;
+        }
+
+        std::array<std::vector<uint64_t>, table_count> m_tables;
+        uint64_t m_sorted{};
+        string_heap m_strings;
+        blob_heap m_blobs;
+        guid_heap m_guids;
+        std::string m_version{ "WindowsRuntime 1.4" };
+    };
+}
@@ -3,13 +3,18 @@
 #include "../base.h"
 #include "../meta_reader/pe.h"
 #include <algorithm>
-#include <fstream>
+#include <cerrno>
 #include <stdint.h>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <filesystem>
 
+#if !XLANG_PLATFORM_WINDOWS
+#include <limits.h>
+#include <sys/uio.h>
+#endif
+
 namespace xlang::meta::writer
 {
     struct pe_writer
@@ -38,57 +43,42 @@ namespace xlang::meta::writer
             m_header.defer_rva(&(nt_header->OptionalHeader.DataDirectory[com_directory].VirtualAddress), &s, cli_header);
         }
 
+        // Writes the headers, padding and section bodies straight from where they live rather than
+        // assembling the whole image in memory first. The image is written next to path and renamed
+        // into place, so a failed write never leaves a truncated file behind.
         void save_to_file(std::filesystem::path const& path)
-        {
-            std::basic_ofstream<uint8_t> output_file{ path, std::ios::binary };
-            auto const output = save_to_memory();
-            output_file.write(output.data(), output.size());
-        }
-
-        std::vector<uint8_t> save_to_memory()
         {
             resolve();
             update_header();
-            uint32_t raw_size = m_sections.back().physical_offset() + static_cast<uint32_t>(m_sections.back().size());
-            std::vector<uint8_t> output;
+            auto const section_headers = get_section_headers();
+            auto temp = path;
+            temp += ".tmp";
 
-            // Write the top headers
-            output.reserve(raw_size);
+            try
             {
-                auto headers_start = m_header.as<uint8_t>(0);
-                auto headers_end = headers_start + m_header.size();
-                output.insert(output.end(), headers_start, headers_end);
+                write_image(temp, section_headers);
+                std::filesystem::rename(temp, path);
             }
-            
-            // Write each section header
-            for (auto const& s : m_sections)
+            catch (...)
             {
-                impl::image_section_header header{};
-                XLANG_ASSERT(s.name().size() <= 8);
-                std::copy(s.name().begin(), s.name().end(), header.Name);
-                header.Misc.VirtualSize = static_cast<uint32_t>(s.size());
-                header.VirtualAddress = s.virtual_offset();
-                header.SizeOfRawData = round_up(header.Misc.VirtualSize, file_alignment);
-                header.PointerToRawData = s.physical_offset();
-                header.Characteristics = 0x40000020; // IMAGE_SCN_MEM_READ | IMAGE_SCN_CNT_CODE
-                
-                auto begin = reinterpret_cast<uint8_t*>(&header);
-                auto end = begin + sizeof(impl::image_section_header);
-                output.insert(output.end(), begin, end);
+                std::error_code error;
+                std::filesystem::remove(temp, error);
+                throw;
             }
+        }
 
-            // Write the sections
-            for (auto const& s : m_sections)
-            {
-                // Alignment padding
-                XLANG_ASSERT(output.size() <= s.physical_offset());
-                XLANG_ASSERT((s.physical_offset() & (file_alignment - 1)) == 0);
-                output.resize(s.physical_offset());
+        std::vector<uint8_t> save_to_memory()
+        {
+            resolve();
+            update_header();
+            auto const section_headers = get_section_headers();
+            std::vector<uint8_t> output;
+            output.reserve(m_sections.back().physical_offset() + m_sections.back().size());
 
-                auto begin = s.as<uint8_t>(0);
-                auto end = begin + s.size();
-                output.insert(output.end(), begin, end);
-            }
+            for_each_chunk(section_headers, [&](uint8_t const* const first, std::size_t const size)
+            {
+                output.insert(output.end(), first, first + size);
+            });
 
             return output;
         }
@@ -263,6 +253,128 @@ namespace xlang::meta::writer
             return section_headers_offset + static_cast<uint32_t>(m_sections.size() * sizeof(impl::image_section_header));
         }
 
+        std::vector<impl::image_section_header> get_section_headers() const
+        {
+            std::vector<impl::image_section_header> headers;
+            headers.reserve(m_sections.size());
+
+            for (auto const& s : m_sections)
+            {
+                impl::image_section_header header{};
+                XLANG_ASSERT(s.name().size() <= 8);
+                std::copy(s.name().begin(), s.name().end(), header.Name);
+                header.Misc.VirtualSize = static_cast<uint32_t>(s.size());
+                header.VirtualAddress = s.virtual_offset();
+                header.SizeOfRawData = round_up(header.Misc.VirtualSize, file_alignment);
+                header.PointerToRawData = s.physical_offset();
+                header.Characteristics = 0x40000020; // IMAGE_SCN_MEM_READ | IMAGE_SCN_CNT_CODE
+                headers.push_back(header);
+            }
+
+            return headers;
+        }
+
+        void write_image(std::filesystem::path const& path, std::vector<impl::image_section_header> const& section_headers) const
+        {
+#if XLANG_PLATFORM_WINDOWS
+            output_file file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+
+            if (!file)
+            {
+                throw_invalid("Could not create file '", path.string(), "'");
+            }
+
+            for_each_chunk(section_headers, [&](uint8_t const* const first, std::size_t const size)
+            {
+                DWORD written{};
+
+                if (!WriteFile(file.value, first, static_cast<DWORD>(size), &written, nullptr) || written != size)
+                {
+                    throw_invalid("Could not write file '", path.string(), "'");
+                }
+            });
+#else
+            output_file file{ open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666) };
+
+            if (!file)
+            {
+                throw_invalid("Could not create file '", path.string(), "'");
+            }
+
+            std::vector<iovec> chunks;
+
+            for_each_chunk(section_headers, [&](uint8_t const* const first, std::size_t const size)
+            {
+                chunks.push_back({ const_cast<uint8_t*>(first), size });
+            });
+
+            for (auto next = chunks.begin(); next != chunks.end();)
+            {
+                auto const count = static_cast<int>(std::min<std::ptrdiff_t>(chunks.end() - next, IOV_MAX));
+                auto written = writev(file.value, &*next, count);
+
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    throw_invalid("Could not write file '", path.string(), "'");
+                }
+
+                // A short write leaves the remainder of the current chunk to be written next time.
+                for (; next != chunks.end() && static_cast<std::size_t>(written) >= next->iov_len; ++next)
+                {
+                    written -= next->iov_len;
+                }
+
+                if (written)
+                {
+                    next->iov_base = static_cast<uint8_t*>(next->iov_base) + written;
+                    next->iov_len -= written;
+                }
+            }
+#endif
+
+            // Errors such as a full disk may only be reported when the file is closed.
+            if (!file.close())
+            {
+                throw_invalid("Could not write file '", path.string(), "'");
+            }
+        }
+
+        // Calls callback with each contiguous run of the image in file order: the top headers, the
+        // section headers, and each section preceded by its alignment padding.
+        template <typename F>
+        void for_each_chunk(std::vector<impl::image_section_header> const& section_headers, F&& callback) const
+        {
+            static constexpr uint8_t padding[file_alignment]{};
+
+            callback(m_header.as<uint8_t>(0), m_header.size());
+            callback(reinterpret_cast<uint8_t const*>(section_headers.data()), section_headers.size() * sizeof(impl::image_section_header));
+            std::size_t offset = m_header.size() + section_headers.size() * sizeof(impl::image_section_header);
+
+            for (auto const& s : m_sections)
+            {
+                XLANG_ASSERT(offset <= s.physical_offset());
+                XLANG_ASSERT((s.physical_offset() & (file_alignment - 1)) == 0);
+                XLANG_ASSERT(s.physical_offset() - offset < file_alignment);
+
+                if (offset != s.physical_offset())
+                {
+                    callback(padding, s.physical_offset() - offset);
+                }
+
+                if (s.size())
+                {
+                    callback(s.as<uint8_t>(0), s.size());
+                }
+
+                offset = s.physical_offset() + s.size();
+            }
+        }
+
         void resolve()
         {
             m_header.virtual_offset(0);
@@ -293,7 +405,7 @@ namespace xlang::meta::writer
             uint32_t const raw_header_size = get_raw_end_of_headers();
             {
                 auto dos_header = get_dos_header();
-                dos_header->e_magic = 0x5a4d; // "MZ
+                dos_header->e_signature = 0x5a4d; // "MZ
                 dos_header->e_lfanew = nt_header_offset;
             }
             {
@@ -327,6 +439,44 @@ namespace xlang::meta::writer
             }
         }
 
+        struct output_file
+        {
+#if XLANG_PLATFORM_WINDOWS
+            using handle_type = HANDLE;
+#else
+            using handle_type = int;
+            static constexpr handle_type INVALID_HANDLE_VALUE = -1;
+#endif
+
+            handle_type value{ INVALID_HANDLE_VALUE };
+
+            ~output_file() noexcept
+            {
+                close();
+            }
+
+            bool close() noexcept
+            {
+                if (value == INVALID_HANDLE_VALUE)
+                {
+                    return true;
+                }
+
+#if XLANG_PLATFORM_WINDOWS
+                bool const closed = CloseHandle(value) != 0;
+#else
+                bool const closed = ::close(value) == 0;
+#endif
+                value = INVALID_HANDLE_VALUE;
+                return closed;
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return value != INVALID_HANDLE_VALUE;
+            }
+        };
+
         section m_header{ "" };
         std::vector<section> m_sections;
     };
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "../../meta_reader.h"
+#include <deque>
+
+namespace xlang::meta::writer
+{
+    // Collects the input types added to it along with every input type they reach through base
+    // types, interfaces, generic constraints, member signatures and attributes, so that the result
+    // can be passed to merge_writer::filter without leaving references to types that were removed.
+    // Types that live in databases that are not inputs are not followed since the merged module
+    // only refers to them.
+    struct type_walker
+    {
+        explicit type_walker(reader::cache const& c) : m_cache(c)
+        {
+        }
+
+        void add_input(reader::database const& db)
+        {
+            auto& nesting = m_nesting[&db];
+
+            for (auto&& nested : db.NestedClass)
+            {
+                auto const inner = db.NestedClass.get_value<uint32_t>(nested.index(), 0) - 1;
+                auto const outer = db.NestedClass.get_value<uint32_t>(nested.index(), 1) - 1;
+                nesting.enclosing[inner] = outer;
+                nesting.nested.emplace(outer, inner);
+            }
+        }
+
+        void add(reader::TypeDef const& type)
+        {
+            if (!type)
+            {
+                return;
+            }
+
+            auto nesting = m_nesting.find(&type.get_database());
+
+            if (nesting == m_nesting.end())
+            {
+                return;
+            }
+
+            auto outer = type.index();
+
+            for (auto enclosing = nesting->second.enclosing.find(outer); enclosing != nesting->second.enclosing.end(); enclosing = nesting->second.enclosing.find(outer))
+            {
+                outer = enclosing->second;
+            }
+
+            enqueue({ &type.get_database().TypeDef, outer });
+        }
+
+        void run()
+        {
+            while (!m_queue.empty())
+            {
+                auto const type = m_queue.front();
+                m_queue.pop_front();
+                walk(type);
+            }
+        }
+
+        // The full names of the top-level types that were reached.
+        std::set<std::string> const& names() const noexcept
+        {
+            return m_names;
+        }
+
+        bool includes(reader::TypeDef const& type) const
+        {
+            std::string name{ type.TypeNamespace() };
+            name += '.';
+            name += type.TypeName();
+            return m_names.count(name) != 0;
+        }
+
+    private:
+
+        struct nesting
+        {
+            std::map<uint32_t, uint32_t> enclosing;
+            std::multimap<uint32_t, uint32_t> nested;
+        };
+
+        void enqueue(reader::TypeDef const& type)
+        {
+            if (!m_visited.emplace(&type.get_database(), type.index()).second)
+            {
+                return;
+            }
+
+            auto const& nesting = m_nesting[&type.get_database()];
+
+            if (!nesting.enclosing.count(type.index()))
+            {
+                std::string name{ type.TypeNamespace() };
+                name += '.';
+                name += type.TypeName();
+                m_names.insert(name);
+            }
+
+            m_queue.push_back(type);
+
+            auto [first, last] = nesting.nested.equal_range(type.index());
+
+            for (; first != last; ++first)
+            {
+                enqueue({ &type.get_database().TypeDef, first->second });
+            }
+        }
+
+        void walk(reader::TypeDef const& type)
+        {
+            visit(type.Extends());
+            visit(type.CustomAttribute());
+            visit(type.GenericParam());
+
+            for (auto&& impl : type.InterfaceImpl())
+            {
+                visit(impl.Interface());
+                visit(impl.CustomAttribute());
+            }
+
+            for (auto&& field : type.FieldList())
+            {
+                visit(field.Signature().Type());
+                visit(field.CustomAttribute());
+            }
+
+            for (auto&& method : type.MethodList())
+            {
+                auto const& signature = method.Signature();
+
+                if (signature.ReturnType())
+                {
+                    visit(signature.ReturnType().Type());
+                }
+
+                for (auto&& param : signature.Params())
+                {
+                    visit(param.Type());
+                }
+
+                for (auto&& param : method.ParamList())
+                {
+                    visit(param.CustomAttribute());
+                }
+
+                visit(method.CustomAttribute());
+                visit(method.GenericParam());
+            }
+
+            for (auto&& property : type.PropertyList())
+            {
+                visit(property.Type().Type());
+                visit(property.CustomAttribute());
+            }
+
+            for (auto&& event : type.EventList())
+            {
+                visit(event.EventType());
+                visit(event.CustomAttribute());
+            }
+        }
+
+        void visit(reader::coded_index<reader::TypeDefOrRef> const& type)
+        {
+            if (!type)
+            {
+                return;
+            }
+
+            switch (type.type())
+            {
+            case reader::TypeDefOrRef::TypeDef:
+                add(type.TypeDef());
+                break;
+
+            case reader::TypeDefOrRef::TypeRef:
+                add(find(type.TypeRef()));
+                break;
+
+            case reader::TypeDefOrRef::TypeSpec:
+                visit(type.TypeSpec().Signature().GenericTypeInst());
+                break;
+            }
+        }
+
+        void visit(reader::GenericTypeInstSig const& type)
+        {
+            visit(type.GenericType());
+
+            for (auto&& arg : type.GenericArgs())
+            {
+                visit(arg);
+            }
+        }
+
+        void visit(reader::TypeSig const& type)
+        {
+            if (auto index = std::get_if<reader::coded_index<reader::TypeDefOrRef>>(&type.Type()))
+            {
+                visit(*index);
+            }
+            else if (auto instance = std::get_if<reader::GenericTypeInstSig>(&type.Type()))
+            {
+                visit(*instance);
+            }
+        }
+
+        void visit(std::pair<reader::GenericParam, reader::GenericParam> const& params)
+        {
+            for (auto&& param : params)
+            {
+                visit(param.CustomAttribute());
+
+                for (auto&& constraint : param.GenericParamConstraint())
+                {
+                    visit(constraint.Constraint());
+                    visit(constraint.CustomAttribute());
+                }
+            }
+        }
+
+        // Activation, static and composition factories are only named by the System.Type arguments
+        // of their attributes, so those are followed as well.
+        void visit(std::pair<reader::CustomAttribute, reader::CustomAttribute> const& attributes)
+        {
+            for (auto&& attribute : attributes)
+            {
+                auto const [type_namespace, type_name] = attribute.TypeNamespaceAndName();
+                add(m_cache.find(type_namespace, type_name));
+
+                if (type_namespace != "Windows.Foundation.Metadata")
+                {
+                    continue;
+                }
+
+                for (auto&& arg : attribute.Value().FixedArgs())
+                {
+                    if (auto elem = std::get_if<reader::ElemSig>(&arg.value))
+                    {
+                        if (auto type = std::get_if<reader::ElemSig::SystemType>(&elem->value))
+                        {
+                            add(m_cache.find(type->name));
+                        }
+                    }
+                }
+            }
+        }
+
+        reader::cache const& m_cache;
+        std::map<reader::database const*, nesting> m_nesting;
+        std::set<std::pair<reader::database const*, uint32_t>> m_visited;
+        std::deque<reader::TypeDef> m_queue;
+        std::set<std::string> m_names;
+    };
+}
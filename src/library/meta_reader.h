@@ -1,6 +1,7 @@
 #pragma once
 
 #include "impl/base.h"
+#include "task_group.h"
 #include "impl/meta_reader/pe.h"
 #include "impl/meta_reader/view.h"
 #include "impl/meta_reader/enum.h"
@@ -17,4 +18,5 @@
 #include "impl/meta_reader/cache.h"
 #include "impl/meta_reader/filter.h"
 #include "impl/meta_reader/custom_attribute.h"
+#include "impl/meta_reader/snapshot.h"
 #include "impl/meta_reader/helpers.h"
@@ -1,3 +1,7 @@
 #pragma once
 
 #include "impl/meta_writer/pe_writer.h"
+#include "impl/meta_writer/heaps.h"
+#include "impl/meta_writer/metadata_writer.h"
+#include "impl/meta_writer/merge_writer.h"
+#include "impl/meta_writer/type_walker.h"
@@ -1,22 +1,460 @@
 #pragma once
 
 #include "impl/base.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#if !XLANG_PLATFORM_WINDOWS
+#include <poll.h>
+#endif
 
 namespace xlang
 {
+    struct task_group_options
+    {
+        // The most tasks that may run at once, counting the thread waiting on a group. Zero uses
+        // one worker per hardware thread.
+        uint32_t jobs{};
+
+        // Requires each worker to hold a token from the GNU make jobserver named in MAKEFLAGS,
+        // if there is one, so that the tasks share the build's job limit.
+        bool jobserver{};
+    };
+
+    // Maps the value of a tool's -jobs option to options, deferring to the make jobserver when
+    // no explicit count is given.
+    inline task_group_options get_task_group_options(std::string const& jobs)
+    {
+        task_group_options options;
+
+        if (jobs.empty())
+        {
+            options.jobserver = true;
+            return options;
+        }
+
+        auto const first = jobs.c_str();
+        char* last{};
+        auto const value = std::strtoul(first, &last, 10);
+
+        if (last == first || *last || !value || value > 0xffff)
+        {
+            throw_invalid("'", jobs, "' is not a valid number of jobs");
+        }
+
+        options.jobs = static_cast<uint32_t>(value);
+        return options;
+    }
+
+    namespace impl
+    {
+        // A client of the GNU make jobserver. The process implicitly owns one job; every other
+        // concurrent job needs a token taken from the jobserver and handed back when it is done.
+        struct jobserver
+        {
+            jobserver(jobserver const&) = delete;
+            jobserver& operator=(jobserver const&) = delete;
+
+            static std::unique_ptr<jobserver> open()
+            {
+                auto const flags = std::getenv("MAKEFLAGS");
+                return flags ? open(flags) : nullptr;
+            }
+
+            // Returns the jobserver named by the given MAKEFLAGS value, if there is one that can be
+            // used without blocking.
+            static std::unique_ptr<jobserver> open(std::string_view const& makeflags)
+            {
+                auto const auth = get_auth(makeflags);
+
+                if (auth.empty())
+                {
+                    return {};
+                }
+
+                std::unique_ptr<jobserver> result{ new jobserver };
+
+#if XLANG_PLATFORM_WINDOWS
+                result->m_semaphore = OpenSemaphoreA(SEMAPHORE_ALL_ACCESS, FALSE, std::string{ auth }.c_str());
+
+                if (!result->m_semaphore)
+                {
+                    return {};
+                }
+#else
+                if (auth.substr(0, 5) == "fifo:")
+                {
+                    result->m_read = ::open(std::string{ auth.substr(5) }.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+                    result->m_write = result->m_read;
+                    result->m_owned = true;
+                }
+                else
+                {
+                    int read_fd{ -1 };
+                    int write_fd{ -1 };
+
+                    if (std::sscanf(std::string{ auth }.c_str(), "%d,%d", &read_fd, &write_fd) != 2 ||
+                        fcntl(read_fd, F_GETFD) == -1 || fcntl(write_fd, F_GETFD) == -1)
+                    {
+                        return {};
+                    }
+
+                    // Reopening the pipe gives a separate open file description that can be made
+                    // non-blocking without affecting make or other clients sharing the pipe. Where
+                    // that isn't possible the jobserver is not used, since a blocking read could
+                    // leave a worker waiting on a token that another client took first.
+                    auto const reopened = "/proc/self/fd/" + std::to_string(read_fd);
+                    result->m_read = ::open(reopened.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+                    result->m_owned = result->m_read != -1;
+                    result->m_write = write_fd;
+                }
+
+                if (result->m_read == -1)
+                {
+                    return {};
+                }
+#endif
+
+                return result;
+            }
+
+            ~jobserver() noexcept
+            {
+#if XLANG_PLATFORM_WINDOWS
+                if (m_semaphore)
+                {
+                    CloseHandle(m_semaphore);
+                }
+#else
+                if (m_owned)
+                {
+                    close(m_read);
+                }
+#endif
+            }
+
+            // Waits up to timeout for a token, which must later be passed to release.
+            std::optional<char> acquire(std::chrono::milliseconds const timeout) noexcept
+            {
+#if XLANG_PLATFORM_WINDOWS
+                if (WaitForSingleObject(m_semaphore, static_cast<DWORD>(timeout.count())) == WAIT_OBJECT_0)
+                {
+                    return '+';
+                }
+#else
+                pollfd descriptor{ m_read, POLLIN, 0 };
+                char token{};
+
+                if (poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0 && read(m_read, &token, 1) == 1)
+                {
+                    return token;
+                }
+#endif
+                return {};
+            }
+
+            void release([[maybe_unused]] char const token) noexcept
+            {
+#if XLANG_PLATFORM_WINDOWS
+                ReleaseSemaphore(m_semaphore, 1, nullptr);
+#else
+                while (write(m_write, &token, 1) == -1 && errno == EINTR)
+                {
+                }
+#endif
+            }
+
+            // Returns the value of the last --jobserver-auth or --jobserver-fds option in MAKEFLAGS.
+            static std::string_view get_auth(std::string_view const& makeflags) noexcept
+            {
+                std::string_view auth;
+                std::size_t found{};
+
+                for (auto&& name : { "--jobserver-auth="sv, "--jobserver-fds="sv })
+                {
+                    if (auto const pos = makeflags.rfind(name); pos != std::string_view::npos && pos >= found)
+                    {
+                        found = pos;
+                        auth = makeflags.substr(pos + name.size());
+                        auth = auth.substr(0, auth.find(' '));
+                    }
+                }
+
+                return auth;
+            }
+
+        private:
+
+            jobserver() noexcept = default;
+
+#if XLANG_PLATFORM_WINDOWS
+            HANDLE m_semaphore{};
+#else
+            int m_read{ -1 };
+            int m_write{ -1 };
+            bool m_owned{};
+#endif
+        };
+
+        struct task_group_state
+        {
+            std::atomic<std::size_t> pending{};
+            std::mutex lock;
+            std::condition_variable done;
+            std::exception_ptr exception;
+        };
+
+        struct pool_task
+        {
+            std::function<void()> callback;
+            std::shared_ptr<task_group_state> group;
+        };
+
+        // A fixed set of workers, one per hardware thread, each with its own queue. Workers take the
+        // newest task from their own queue and steal the oldest from the others when it runs dry.
+        // Tasks added from outside the pool go to a shared queue that every worker steals from.
+        struct thread_pool
+        {
+            thread_pool(thread_pool const&) = delete;
+            thread_pool& operator=(thread_pool const&) = delete;
+
+            static thread_pool& instance()
+            {
+                static thread_pool pool{ options() };
+                return pool;
+            }
+
+            static task_group_options& options() noexcept
+            {
+                static task_group_options value;
+                return value;
+            }
+
+            ~thread_pool() noexcept
+            {
+                {
+                    std::lock_guard guard{ m_lock };
+                    m_stop = true;
+                }
+
+                m_wake.notify_all();
+
+                for (auto&& thread : m_threads)
+                {
+                    thread.join();
+                }
+            }
+
+            void submit(pool_task&& task)
+            {
+                auto& queue = current() ? *current() : m_queues.back();
+
+                // Counted while the queue is still locked so that a worker taking the task can never
+                // bring the count below zero.
+                {
+                    std::lock_guard guard{ queue.lock };
+                    queue.tasks.push_back(std::move(task));
+                    ++m_queued;
+                }
+
+                {
+                    std::lock_guard guard{ m_lock };
+                }
+
+                m_wake.notify_one();
+            }
+
+            // Runs one queued task on the calling thread, returning false if there was none.
+            bool run_one()
+            {
+                auto const first = current() ? static_cast<std::size_t>(current() - m_queues.data()) : m_queues.size() - 1;
+
+                return run_at(first);
+            }
+
+        private:
+
+            struct queue
+            {
+                std::mutex lock;
+                std::deque<pool_task> tasks;
+            };
+
+            explicit thread_pool(task_group_options const& options) :
+                m_queues((options.jobs ? options.jobs - 1 : std::max(2u, std::thread::hardware_concurrency())) + 1),
+                m_jobserver(options.jobserver ? jobserver::open() : nullptr)
+            {
+                auto const count = m_queues.size() - 1;
+                m_threads.reserve(count);
+
+                for (std::size_t index{}; index < count; ++index)
+                {
+                    m_threads.emplace_back([this, index]
+                    {
+                        current() = &m_queues[index];
+                        work(index);
+                    });
+                }
+            }
+
+            static queue*& current() noexcept
+            {
+                static thread_local queue* value{};
+                return value;
+            }
+
+            void work(std::size_t const index)
+            {
+                while (true)
+                {
+                    if (m_jobserver ? run_with_token(index) : run_at(index))
+                    {
+                        continue;
+                    }
+
+                    std::unique_lock guard{ m_lock };
+                    m_wake.wait(guard, [&] { return m_stop || m_queued; });
+
+                    if (m_stop)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            bool run_at(std::size_t const index)
+            {
+                if (auto task = take(index))
+                {
+                    run(*task);
+                    return true;
+                }
+
+                return false;
+            }
+
+            // The token is taken before the task so that a worker waiting on the jobserver never
+            // holds back work that a thread waiting on its group could be running instead.
+            bool run_with_token(std::size_t const index)
+            {
+                if (!m_queued || stopping())
+                {
+                    return false;
+                }
+
+                auto const token = m_jobserver->acquire(std::chrono::milliseconds{ 10 });
+
+                if (!token)
+                {
+                    return true;
+                }
+
+                run_at(index);
+                m_jobserver->release(*token);
+                return true;
+            }
+
+            bool stopping() noexcept
+            {
+                std::lock_guard guard{ m_lock };
+                return m_stop;
+            }
+
+            std::optional<pool_task> take(std::size_t const first)
+            {
+                if (!m_queued)
+                {
+                    return {};
+                }
+
+                {
+                    auto& own = m_queues[first];
+                    std::lock_guard guard{ own.lock };
+
+                    if (!own.tasks.empty())
+                    {
+                        std::optional<pool_task> task{ std::move(own.tasks.back()) };
+                        own.tasks.pop_back();
+                        --m_queued;
+                        return task;
+                    }
+                }
+
+                for (std::size_t offset = 1; offset < m_queues.size(); ++offset)
+                {
+                    auto& other = m_queues[(first + offset) % m_queues.size()];
+                    std::lock_guard guard{ other.lock };
+
+                    if (!other.tasks.empty())
+                    {
+                        std::optional<pool_task> task{ std::move(other.tasks.front()) };
+                        other.tasks.pop_front();
+                        --m_queued;
+                        return task;
+                    }
+                }
+
+                return {};
+            }
+
+            static void run(pool_task& task) noexcept
+            {
+                auto& group = *task.group;
+
+                try
+                {
+                    task.callback();
+                }
+                catch (...)
+                {
+                    std::lock_guard guard{ group.lock };
+
+                    if (!group.exception)
+                    {
+                        group.exception = std::current_exception();
+                    }
+                }
+
+                task.callback = nullptr;
+
+                if (--group.pending == 0)
+                {
+                    std::lock_guard guard{ group.lock };
+                    group.done.notify_all();
+                }
+            }
+
+            std::vector<queue> m_queues;
+            std::unique_ptr<jobserver> m_jobserver;
+            std::vector<std::thread> m_threads;
+            std::atomic<std::size_t> m_queued{};
+            std::mutex m_lock;
+            std::condition_variable m_wake;
+            bool m_stop{};
+        };
+    }
+
     struct task_group
     {
         task_group(task_group const&) = delete;
         task_group& operator=(task_group const&) = delete;
 
-        task_group() noexcept = default;
+        task_group() = default;
+
+        // Sets how many tasks may run at once. This only takes effect if called before the first
+        // task is added to any group.
+        static void configure(task_group_options const& options) noexcept
+        {
+            impl::thread_pool::options() = options;
+        }
 
         ~task_group() noexcept
         {
-            for (auto&& task : m_tasks)
-            {
-                task.wait();
-            }
+            wait();
         }
 
         template <typename T>
@@ -25,27 +463,40 @@ namespace xlang
 #if defined(XLANG_DEBUG)
             callback();
 #else
-            m_tasks.push_back(std::async(std::forward<T>(callback)));
+            ++m_state->pending;
+            impl::thread_pool::instance().submit({ std::forward<T>(callback), m_state });
 #endif
         }
 
+        // Waits for every task added so far, running queued tasks on the calling thread rather than
+        // blocking while there is work to do, and then rethrows the first exception raised by any
+        // of them.
         void get()
         {
-            auto tasks = std::move(m_tasks);
+            wait();
 
-            for (auto&& task : tasks)
+            if (auto exception = std::exchange(m_state->exception, nullptr))
             {
-                task.wait();
+                std::rethrow_exception(exception);
             }
+        }
+
+    private:
 
-            for (auto&& task : tasks)
+        void wait() noexcept
+        {
+            while (m_state->pending)
             {
-                task.get();
+                if (impl::thread_pool::instance().run_one())
+                {
+                    continue;
+                }
+
+                std::unique_lock guard{ m_state->lock };
+                m_state->done.wait_for(guard, std::chrono::milliseconds{ 1 }, [&] { return m_state->pending == 0; });
             }
         }
 
-    private:
-
-        std::vector<std::future<void>> m_tasks;
+        std::shared_ptr<impl::task_group_state> m_state{ std::make_shared<impl::task_group_state>() };
     };
 }
@@ -1,19 +1,553 @@
 #pragma once
 
 #include "impl/base.h"
+#include <cinttypes>
+
+namespace xlang::impl
+{
+    // A fast, non-cryptographic 64-bit hash of text that may arrive in pieces of any size.
+    struct content_hash
+    {
+        void update(char const* data, std::size_t size) noexcept
+        {
+            m_size += size;
+
+            for (; m_pending_size && size; ++data, --size)
+            {
+                add_pending(*data);
+            }
+
+            for (; size >= 8; data += 8, size -= 8)
+            {
+                mix(read_word(data));
+            }
+
+            for (; size; ++data, --size)
+            {
+                add_pending(*data);
+            }
+        }
+
+        void operator()(char const* const data, std::size_t const size) noexcept
+        {
+            update(data, size);
+        }
+
+        // Continues with text that was hashed separately. The result differs from hashing the
+        // joined text directly but tells changes apart just as well.
+        void append(content_hash const& other) noexcept
+        {
+            mix(other.value());
+            m_size += other.m_size;
+        }
+
+        uint64_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        uint64_t value() const noexcept
+        {
+            auto hash = m_hash ^ (m_pending * prime1) ^ m_size;
+            hash ^= hash >> 33;
+            hash *= prime2;
+            hash ^= hash >> 29;
+            hash *= prime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+    private:
+
+        static constexpr uint64_t prime1{ 0x9e3779b185ebca87 };
+        static constexpr uint64_t prime2{ 0xc2b2ae3d27d4eb4f };
+        static constexpr uint64_t prime3{ 0x165667b19e3779f9 };
+
+        static uint64_t read_word(char const* const data) noexcept
+        {
+            uint64_t word{};
+
+            for (uint32_t index{}; index < 8; ++index)
+            {
+                word |= static_cast<uint64_t>(static_cast<uint8_t>(data[index])) << (8 * index);
+            }
+
+            return word;
+        }
+
+        void mix(uint64_t const word) noexcept
+        {
+            m_hash ^= word * prime2;
+            m_hash = ((m_hash << 31) | (m_hash >> 33)) * prime1 + prime3;
+        }
+
+        void add_pending(char const value) noexcept
+        {
+            m_pending |= static_cast<uint64_t>(static_cast<uint8_t>(value)) << (8 * m_pending_size);
+
+            if (++m_pending_size == 8)
+            {
+                mix(m_pending);
+                m_pending = 0;
+                m_pending_size = 0;
+            }
+        }
+
+        uint64_t m_hash{ prime3 };
+        uint64_t m_size{};
+        uint64_t m_pending{};
+        uint32_t m_pending_size{};
+    };
+
+    // Text held in fixed-size blocks so that growing never moves what has already been written.
+    // A buffer may also stream to a file, writing out its blocks as they fill and reusing them,
+    // in which case only the unwritten tail is kept in memory.
+    struct text_buffer
+    {
+        static constexpr std::size_t block_size{ 64 * 1024 };
+
+        text_buffer() = default;
+        text_buffer(text_buffer&&) = default;
+        text_buffer& operator=(text_buffer&&) = default;
+
+        ~text_buffer() noexcept
+        {
+            discard_stream();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_streamed + m_size;
+        }
+
+        char back() const noexcept
+        {
+            if (!m_size)
+            {
+                return m_streamed_back;
+            }
+
+            return m_blocks[(m_size - 1) / block_size][(m_size - 1) % block_size];
+        }
+
+        void append(char const* data, std::size_t size)
+        {
+            while (size)
+            {
+                if (m_size == m_blocks.size() * block_size)
+                {
+                    grow();
+                }
+
+                auto const offset = m_size % block_size;
+                auto const count = std::min(size, block_size - offset);
+                std::memcpy(m_blocks[m_size / block_size].get() + offset, data, count);
+                m_size += count;
+                data += count;
+                size -= count;
+            }
+        }
+
+        void push_back(char const value)
+        {
+            append(&value, 1);
+        }
+
+        // Text at or after offset stays in memory until release is called, so that it can be
+        // read back with substr and removed with truncate.
+        void hold() noexcept
+        {
+            ++m_holds;
+        }
+
+        void release() noexcept
+        {
+            XLANG_ASSERT(m_holds);
+            --m_holds;
+        }
+
+        std::string substr(std::size_t const offset) const
+        {
+            XLANG_ASSERT(offset >= m_streamed);
+            std::string result;
+            result.reserve(size() - offset);
+
+            for_each(offset, [&](char const* const first, std::size_t const count)
+            {
+                result.append(first, count);
+            });
+
+            return result;
+        }
+
+        void truncate(std::size_t const size) noexcept
+        {
+            XLANG_ASSERT(size >= m_streamed && size <= this->size());
+            m_size = size - m_streamed;
+        }
+
+        void clear() noexcept
+        {
+            discard_stream();
+            m_size = 0;
+        }
+
+        // Calls callback with each contiguous run of the text still held in memory.
+        template <typename F>
+        void for_each(F&& callback) const
+        {
+            for_each(m_streamed, callback);
+        }
+
+        bool equal(uint8_t const* data) const noexcept
+        {
+            bool result{ true };
+
+            for_each([&](char const* const first, std::size_t const count)
+            {
+                result = result && std::memcmp(first, data, count) == 0;
+                data += count;
+            });
+
+            return result;
+        }
+
+        bool streaming() const noexcept
+        {
+            return static_cast<bool>(m_stream);
+        }
+
+        void stream(std::string const& path)
+        {
+            XLANG_ASSERT(!streaming());
+            m_stream = std::make_unique<std::ofstream>(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+            if (!*m_stream)
+            {
+                m_stream.reset();
+                throw_invalid("Could not create file '", path, "'");
+            }
+
+            m_stream_path = path;
+            m_stream_hash = {};
+        }
+
+        struct streamed_file
+        {
+            std::string path;
+            content_hash hash;
+        };
+
+        // Writes out the rest of the text and closes the stream, returning the path of the
+        // completed file along with the hash of its contents. The buffer is left empty.
+        streamed_file finish_stream()
+        {
+            XLANG_ASSERT(streaming());
+            write_blocks();
+            m_stream->close();
+
+            if (m_stream->fail())
+            {
+                throw_invalid("Could not write file '", m_stream_path, "'");
+            }
+
+            m_stream.reset();
+            m_streamed = 0;
+            m_streamed_back = 0;
+            return { std::move(m_stream_path), m_stream_hash };
+        }
+
+    private:
+
+        template <typename F>
+        void for_each(std::size_t offset, F&& callback) const
+        {
+            offset -= m_streamed;
+
+            while (offset < m_size)
+            {
+                auto const position = offset % block_size;
+                auto const count = std::min(block_size - position, m_size - offset);
+                callback(m_blocks[offset / block_size].get() + position, count);
+                offset += count;
+            }
+        }
+
+        void grow()
+        {
+            if (streaming() && !m_holds && m_size)
+            {
+                write_blocks();
+                return;
+            }
+
+            m_blocks.push_back(std::make_unique<char[]>(block_size));
+        }
+
+        void write_blocks()
+        {
+            if (!m_size)
+            {
+                return;
+            }
+
+            m_streamed_back = back();
+
+            for_each([&](char const* const first, std::size_t const count)
+            {
+                m_stream->write(first, count);
+                m_stream_hash.update(first, count);
+            });
+
+            m_streamed += m_size;
+            m_size = 0;
+        }
+
+        void discard_stream() noexcept
+        {
+            if (!m_stream)
+            {
+                return;
+            }
+
+            m_stream.reset();
+            std::error_code ec;
+            std::filesystem::remove(m_stream_path, ec);
+            m_stream_path.clear();
+            m_streamed = 0;
+            m_streamed_back = 0;
+        }
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        std::size_t m_size{};
+        std::size_t m_streamed{};
+        char m_streamed_back{};
+        uint32_t m_holds{};
+        std::unique_ptr<std::ofstream> m_stream;
+        std::string m_stream_path;
+        content_hash m_stream_hash;
+    };
+}
 
 namespace xlang::text
 {
+    // Remembers the size and hash of each file written by flush_to_file, along with the file's
+    // size and write time on disk, so that an unchanged file can be recognized without reading it.
+    // Writers consult the manifest installed with current(); files it knows nothing about, or
+    // that have changed on disk since, fall back to comparing their contents.
+    struct output_manifest
+    {
+        output_manifest(output_manifest const&) = delete;
+        output_manifest& operator=(output_manifest const&) = delete;
+
+        explicit output_manifest(std::string path) : m_path(std::move(path))
+        {
+            std::ifstream file{ m_path, std::ios::binary };
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                entry value{};
+                int offset{};
+
+                if (std::sscanf(line.c_str(), "%" SCNx64 " %" SCNu64 " %" SCNd64 " %n", &value.hash, &value.size, &value.write_time, &offset) == 3 && offset)
+                {
+                    m_entries[line.substr(offset)] = value;
+                }
+            }
+        }
+
+        static output_manifest*& current() noexcept
+        {
+            static output_manifest* value{};
+            return value;
+        }
+
+        // Returns whether the file on disk holds text of the given size and hash, or nothing if
+        // that can't be told without reading it.
+        std::optional<bool> check(std::string const& filename, uint64_t const size, uint64_t const hash) const
+        {
+            std::lock_guard guard{ m_lock };
+            auto const found = m_entries.find(filename);
+
+            if (found == m_entries.end() || !matches_disk(filename, found->second))
+            {
+                return {};
+            }
+
+            return found->second.size == size && found->second.hash == hash;
+        }
+
+        void update(std::string const& filename, uint64_t const size, uint64_t const hash)
+        {
+            entry value{ hash, size, get_write_time(filename) };
+            std::lock_guard guard{ m_lock };
+            m_entries[filename] = value;
+            m_dirty = true;
+        }
+
+        void save()
+        {
+            std::lock_guard guard{ m_lock };
+
+            if (!m_dirty)
+            {
+                return;
+            }
+
+            auto const temp = m_path + ".tmp";
+
+            {
+                std::ofstream file{ temp, std::ios::out | std::ios::binary | std::ios::trunc };
+
+                for (auto&& [filename, value] : m_entries)
+                {
+                    char buffer[64];
+                    snprintf(buffer, sizeof(buffer), "%016" PRIx64 " %" PRIu64 " %" PRId64 " ", value.hash, value.size, value.write_time);
+                    file << buffer << filename << '\n';
+                }
+
+                if (!file.flush())
+                {
+                    throw_invalid("Could not write file '", temp, "'");
+                }
+            }
+
+            std::filesystem::rename(temp, m_path);
+            m_dirty = false;
+        }
+
+    private:
+
+        struct entry
+        {
+            uint64_t hash;
+            uint64_t size;
+            int64_t write_time;
+        };
+
+        static int64_t get_write_time(std::string const& filename) noexcept
+        {
+            std::error_code ec;
+            auto const time = std::filesystem::last_write_time(filename, ec);
+            return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
+        static bool matches_disk(std::string const& filename, entry const& value) noexcept
+        {
+            std::error_code ec;
+            auto const size = std::filesystem::file_size(filename, ec);
+            return !ec && size == value.size && get_write_time(filename) == value.write_time;
+        }
+
+        std::string m_path;
+        mutable std::mutex m_lock;
+        std::map<std::string, entry> m_entries;
+        bool m_dirty{};
+    };
+
+    // A format string split into text and placeholder segments by its constexpr constructor. When
+    // declared static constexpr, the parsing happens at compile time and writing it dispatches
+    // straight to the arguments without scanning for placeholders.
+    //
+    // The segment array can't be sized by the exact count since the string is only a constant
+    // inside the constructor, so it's sized by the string length up to a fixed cap. A format with
+    // more segments than that fails to compile when declared constexpr.
+    template <std::size_t N>
+    struct format
+    {
+        static_assert(N <= 0xffff, "Format strings are limited to 64KB.");
+
+        static constexpr std::size_t capacity{ N < 128 ? N : 128 };
+
+        struct segment
+        {
+            uint16_t offset{};
+            uint16_t size{};
+            char placeholder{}; // '%' or '@' for arguments, zero for text.
+        };
+
+        constexpr format(char const (&value)[N]) : m_value(value)
+        {
+            std::size_t first{};
+
+            for (std::size_t index{}; index < N - 1; ++index)
+            {
+                auto const c = value[index];
+
+                if (c == '^')
+                {
+                    XLANG_ASSERT(index + 1 < N - 1);
+                    add_text(first, index);
+                    first = ++index;
+                }
+                else if (c == '%' || c == '@')
+                {
+                    add_text(first, index);
+                    next().placeholder = c;
+                    ++m_placeholders;
+                    first = index + 1;
+                }
+            }
+
+            add_text(first, N - 1);
+        }
+
+        constexpr segment const* begin() const noexcept
+        {
+            return m_segments.data();
+        }
+
+        constexpr segment const* end() const noexcept
+        {
+            return m_segments.data() + m_size;
+        }
+
+        constexpr uint32_t placeholders() const noexcept
+        {
+            return m_placeholders;
+        }
+
+        constexpr std::string_view text(segment const& value) const noexcept
+        {
+            return { m_value + value.offset, value.size };
+        }
+
+    private:
+
+        constexpr void add_text(std::size_t const first, std::size_t const last)
+        {
+            if (first != last)
+            {
+                auto& value = next();
+                value.offset = static_cast<uint16_t>(first);
+                value.size = static_cast<uint16_t>(last - first);
+            }
+        }
+
+        constexpr segment& next()
+        {
+            if (m_size == capacity)
+            {
+                throw std::length_error("Format string has too many segments.");
+            }
+
+            return m_segments[m_size++];
+        }
+
+        char const* m_value;
+        std::array<segment, capacity> m_segments{};
+        uint32_t m_size{};
+        uint32_t m_placeholders{};
+    };
+
     template <typename T>
     struct writer_base
     {
         writer_base(writer_base const&) = delete;
         writer_base& operator=(writer_base const&) = delete;
 
-        writer_base()
-        {
-            m_first.reserve(16 * 1024);
-        }
+        writer_base() = default;
 
         template <typename... Args>
         void write(std::string_view const& value, Args const&... args)
@@ -26,6 +560,13 @@ namespace xlang::text
             write_segment(value, args...);
         }
 
+        template <std::size_t N, typename... Args>
+        void write(format<N> const& value, Args const&... args)
+        {
+            XLANG_ASSERT(value.placeholders() == sizeof...(Args));
+            write_segments(value, value.begin(), args...);
+        }
+
         template <typename... Args>
         std::string write_temp(std::string_view const& value, Args const&... args)
         {
@@ -34,12 +575,14 @@ namespace xlang::text
             debug_trace = false;
 #endif
             auto const size = m_first.size();
+            m_first.hold();
 
             XLANG_ASSERT(count_placeholders(value) == sizeof...(Args));
             write_segment(value, args...);
 
-            std::string result{ m_first.data() + size, m_first.size() - size };
-            m_first.resize(size);
+            std::string result{ m_first.substr(size) };
+            m_first.truncate(size);
+            m_first.release();
 
 #if defined(XLANG_DEBUG)
             debug_trace = restore_debug_trace;
@@ -49,7 +592,7 @@ namespace xlang::text
 
         void write_impl(std::string_view const& value)
         {
-            m_first.insert(m_first.end(), value.begin(), value.end());
+            m_first.append(value.data(), value.size());
 
 #if defined(XLANG_DEBUG)
             if (debug_trace)
@@ -138,22 +681,55 @@ namespace xlang::text
             std::swap(m_second, m_first);
         }
 
+        // Writes the text to a temporary file next to filename as it is produced rather than
+        // keeping it all in memory. The text may still be swapped behind a prefix as usual, and
+        // flush_to_file must then be called with the same filename.
+        void stream_to_file(std::string const& filename)
+        {
+            XLANG_ASSERT(!m_first.size() && !m_second.streaming());
+            m_first.stream(filename + ".tmp");
+        }
+
         void flush_to_console() noexcept
         {
-            printf("%.*s", static_cast<int>(m_first.size()), m_first.data());
-            printf("%.*s", static_cast<int>(m_second.size()), m_second.data());
+            XLANG_ASSERT(!m_first.streaming() && !m_second.streaming());
+
+            auto print = [](char const* const first, std::size_t const size)
+            {
+                printf("%.*s", static_cast<int>(size), first);
+            };
+
+            m_first.for_each(print);
+            m_second.for_each(print);
             m_first.clear();
             m_second.clear();
         }
 
         void flush_to_file(std::string const& filename)
         {
-            if (!file_equal(filename))
+            if (m_first.streaming() || m_second.streaming())
             {
-                std::ofstream file{ filename, std::ios::out | std::ios::binary };
-                file.write(m_first.data(), m_first.size());
-                file.write(m_second.data(), m_second.size());
+                flush_stream_to_file(filename);
             }
+            else
+            {
+                impl::content_hash hash;
+
+                if (output_manifest::current())
+                {
+                    m_first.for_each(hash);
+                    m_second.for_each(hash);
+                }
+
+                if (!unchanged(filename, hash, [&] { return file_equal(filename); }))
+                {
+                    std::ofstream file{ filename, std::ios::out | std::ios::binary };
+                    write_to(file);
+                }
+
+                record(filename, hash);
+            }
+
             m_first.clear();
             m_second.clear();
         }
@@ -165,10 +741,18 @@ namespace xlang::text
 
         std::string flush_to_string()
         {
+            XLANG_ASSERT(!m_first.streaming() && !m_second.streaming());
+
             std::string result;
             result.reserve(m_first.size() + m_second.size());
-            result.assign(m_first.begin(), m_first.end());
-            result.append(m_second.begin(), m_second.end());
+
+            auto append = [&](char const* const first, std::size_t const size)
+            {
+                result.append(first, size);
+            };
+
+            m_first.for_each(append);
+            m_second.for_each(append);
             m_first.clear();
             m_second.clear();
             return result;
@@ -176,7 +760,7 @@ namespace xlang::text
 
         char back()
         {
-            return m_first.empty() ? char{} : m_first.back();
+            return m_first.back();
         }
 
         bool file_equal(std::string const& filename) const
@@ -193,12 +777,7 @@ namespace xlang::text
                 return false;
             }
 
-            if (!std::equal(m_first.begin(), m_first.end(), file.begin(), file.begin() + m_first.size()))
-            {
-                return false;
-            }
-
-            return std::equal(m_second.begin(), m_second.end(), file.begin() + m_first.size(), file.end());
+            return m_first.equal(file.begin()) && m_second.equal(file.begin() + m_first.size());
         }
 
 #if defined(XLANG_DEBUG)
@@ -266,28 +845,161 @@ namespace xlang::text
             }
             else
             {
-                if (value[offset] == '%')
+                write_placeholder(value[offset], first);
+                write_segment(value.substr(offset + 1), rest...);
+            }
+        }
+
+        template <std::size_t N>
+        void write_segments(format<N> const& value, typename format<N>::segment const* first)
+        {
+            for (; first != value.end(); ++first)
+            {
+                write(value.text(*first));
+            }
+        }
+
+        template <std::size_t N, typename First, typename... Rest>
+        void write_segments(format<N> const& value, typename format<N>::segment const* first, First const& argument, Rest const&... rest)
+        {
+            for (; !first->placeholder; ++first)
+            {
+                write(value.text(*first));
+            }
+
+            write_placeholder(first->placeholder, argument);
+            write_segments(value, first + 1, rest...);
+        }
+
+        template <typename First>
+        void write_placeholder(char const placeholder, First const& first)
+        {
+            if (placeholder == '%')
+            {
+                static_cast<T*>(this)->write(first);
+            }
+            else
+            {
+                if constexpr (std::is_convertible_v<First, std::string_view>)
                 {
-                    static_cast<T*>(this)->write(first);
+                    static_cast<T*>(this)->write_code(first);
                 }
                 else
                 {
-                    if constexpr (std::is_convertible_v<First, std::string_view>)
-                    {
-                        static_cast<T*>(this)->write_code(first);
-                    }
-                    else
-                    {
-                        XLANG_ASSERT(false); // '@' placeholders are only for text.
-                    }
+                    XLANG_ASSERT(false); // '@' placeholders are only for text.
                 }
+            }
+        }
 
-                write_segment(value.substr(offset + 1), rest...);
+        void write_to(std::ofstream& file) const
+        {
+            auto write = [&](char const* const first, std::size_t const size)
+            {
+                file.write(first, size);
+            };
+
+            m_first.for_each(write);
+            m_second.for_each(write);
+        }
+
+        template <typename F>
+        static bool unchanged(std::string const& filename, impl::content_hash const& hash, F&& compare)
+        {
+            if (auto manifest = output_manifest::current())
+            {
+                if (auto known = manifest->check(filename, hash.size(), hash.value()))
+                {
+                    return *known;
+                }
+            }
+
+            return compare();
+        }
+
+        static void record(std::string const& filename, impl::content_hash const& hash)
+        {
+            if (auto manifest = output_manifest::current())
+            {
+                manifest->update(filename, hash.size(), hash.value());
             }
         }
 
-        std::vector<char> m_second;
-        std::vector<char> m_first;
+        static bool files_equal(std::string const& left, std::string const& right)
+        {
+            if (!std::filesystem::exists(right))
+            {
+                return false;
+            }
+
+            meta::reader::file_view left_view{ left };
+            meta::reader::file_view right_view{ right };
+            return left_view.size() == right_view.size() && std::equal(left_view.begin(), left_view.end(), right_view.begin());
+        }
+
+        void flush_stream_to_file(std::string const& filename)
+        {
+            XLANG_ASSERT(!(m_first.streaming() && m_second.streaming()));
+
+            if (m_first.streaming())
+            {
+                // Nothing was swapped in front of the streamed text, so whatever follows it can be
+                // appended and the temporary file moved into place.
+                m_second.for_each([&](char const* const first, std::size_t const size)
+                {
+                    m_first.append(first, size);
+                });
+
+                auto const streamed = m_first.finish_stream();
+
+                if (unchanged(filename, streamed.hash, [&] { return files_equal(streamed.path, filename); }))
+                {
+                    std::filesystem::remove(streamed.path);
+                }
+                else
+                {
+                    std::filesystem::rename(streamed.path, filename);
+                }
+
+                record(filename, streamed.hash);
+                return;
+            }
+
+            // A prefix was swapped in front of the streamed text, so the two are joined here. The
+            // prefix is hashed on its own since the streamed text was hashed before it was known.
+            auto const streamed = m_second.finish_stream();
+            impl::content_hash hash;
+            m_first.for_each(hash);
+            hash.append(streamed.hash);
+
+            auto const equal = unchanged(filename, hash, [&]
+            {
+                if (!std::filesystem::exists(filename))
+                {
+                    return false;
+                }
+
+                meta::reader::file_view temp{ streamed.path };
+                meta::reader::file_view file{ filename };
+
+                return file.size() == m_first.size() + temp.size() &&
+                    m_first.equal(file.begin()) &&
+                    std::equal(temp.begin(), temp.end(), file.begin() + m_first.size());
+            });
+
+            if (!equal)
+            {
+                meta::reader::file_view temp{ streamed.path };
+                std::ofstream file{ filename, std::ios::out | std::ios::binary };
+                write_to(file);
+                file.write(reinterpret_cast<char const*>(temp.begin()), temp.size());
+            }
+
+            std::filesystem::remove(streamed.path);
+            record(filename, hash);
+        }
+
+        impl::text_buffer m_second;
+        impl::text_buffer m_first;
     };
 
 
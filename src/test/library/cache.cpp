@@ -0,0 +1,282 @@
+#include "pch.h"
+#include "meta_writer.h"
+#include <random>
+
+using namespace xlang::meta;
+using namespace xlang::meta::writer;
+
+namespace
+{
+    // Builds a module with interface Ns.I, class Ns.C implementing Ns.I through a TypeRef and carrying
+    // Ns.MarkerAttribute, and struct Other.S. If extra is set, interface Ns.D is added as well so
+    // that the file changes size. The build number is stored in the module's MVID.
+    std::vector<uint8_t> make_database(bool const extra, uint8_t const build = 1)
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        uint8_t const mvid[16]{ build, 2, 3 };
+
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+        auto const& parent = get_coded_index_schema(coded_index_id::HasCustomAttribute);
+        auto const& constructor = get_coded_index_schema(coded_index_id::CustomAttributeType);
+        auto const& member_parent = get_coded_index_schema(coded_index_id::MemberRefParent);
+
+        w.add_row(table_id::Module, { 0, strings.add("a.winmd"), w.guids().add(mvid), 0, 0 });
+        w.add_row(table_id::Assembly, { 0x8004, 0, 0, 0, strings.add("a"), 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("ValueType"), strings.add("System") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::Module, 1), strings.add("I"), strings.add("Ns") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::Module, 1), strings.add("MarkerAttribute"), strings.add("Ns") });
+        w.add_row(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x40a1, strings.add("I"), strings.add("Ns"), 0, 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x4101, strings.add("C"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x4109, strings.add("S"), strings.add("Other"), type.encode(table_id::TypeRef, 2), 1, 1 });
+
+        if (extra)
+        {
+            w.add_row(table_id::TypeDef, { 0x40a1, strings.add("D"), strings.add("Ns"), 0, 1, 1 });
+        }
+
+        w.add_row(table_id::InterfaceImpl, { 3, type.encode(table_id::TypeRef, 3) });
+
+        // HasThis, no parameters, void return
+        std::vector<uint8_t> const signature{ 0x20, 0x00, 0x01 };
+        w.add_row(table_id::MemberRef, { member_parent.encode(table_id::TypeRef, 4), strings.add(".ctor"), w.blobs().add(signature) });
+
+        std::vector<uint8_t> const value{ 1, 0, 0, 0 };
+        w.add_row(table_id::CustomAttribute, { parent.encode(table_id::TypeDef, 3), constructor.encode(table_id::MemberRef, 1), w.blobs().add(value) });
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    void write_file(std::filesystem::path const& path, std::vector<uint8_t> const& bytes)
+    {
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+    }
+
+    std::vector<uint8_t> read_file(std::filesystem::path const& path)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    }
+
+    std::vector<std::string> get_names(std::vector<reader::TypeDef> const& types)
+    {
+        std::vector<std::string> names;
+
+        for (auto&& type : types)
+        {
+            names.emplace_back(type.TypeName());
+        }
+
+        return names;
+    }
+
+    // Compares everything a snapshot stores against a cache that indexed the same databases.
+    void require_equal(reader::cache const& actual, reader::cache const& expected)
+    {
+        REQUIRE(actual.namespaces().size() == expected.namespaces().size());
+
+        for (auto&&[namespace_name, members] : expected.namespaces())
+        {
+            auto const found = actual.namespaces().find(namespace_name);
+            REQUIRE(found != actual.namespaces().end());
+            auto const& other = found->second;
+
+            REQUIRE(other.types.size() == members.types.size());
+
+            for (auto&&[name, type] : members.types)
+            {
+                REQUIRE(other.types.count(name) == 1);
+                REQUIRE(actual.find(namespace_name, name).index() == type.index());
+            }
+
+            REQUIRE(get_names(other.interfaces()) == get_names(members.interfaces()));
+            REQUIRE(get_names(other.classes()) == get_names(members.classes()));
+            REQUIRE(get_names(other.enums()) == get_names(members.enums()));
+            REQUIRE(get_names(other.structs()) == get_names(members.structs()));
+            REQUIRE(get_names(other.delegates()) == get_names(members.delegates()));
+            REQUIRE(get_names(other.attributes()) == get_names(members.attributes()));
+            REQUIRE(get_names(other.contracts()) == get_names(members.contracts()));
+        }
+
+        REQUIRE(actual.databases().size() == expected.databases().size());
+        auto const& db = actual.databases().front();
+
+        for (auto&& type : db.TypeRef)
+        {
+            auto const resolved = db.resolve(type);
+            auto const definition = expected.find(type.TypeNamespace(), type.TypeName());
+            REQUIRE(static_cast<bool>(resolved) == static_cast<bool>(definition));
+
+            if (resolved)
+            {
+                REQUIRE(resolved.index() == definition.index());
+            }
+        }
+
+        auto const type = actual.find("Ns", "C");
+        REQUIRE(db.find_attribute(type.coded_index<reader::HasCustomAttribute>(), { "Ns", "MarkerAttribute" }));
+        REQUIRE(!db.find_attribute(type.coded_index<reader::HasCustomAttribute>(), { "Ns", "OtherAttribute" }));
+    }
+}
+
+TEST_CASE("cache snapshot")
+{
+    // A folder unique to this run so that concurrent test runs don't share files.
+    std::random_device random;
+    auto const folder = std::filesystem::temp_directory_path() /
+        ("xlang_test_cache_" + std::to_string(random()) + "_" + std::to_string(random()));
+
+    std::filesystem::create_directories(folder);
+    auto const input = folder / "a.winmd";
+    auto const snapshot = folder / "a.snapshot";
+    write_file(input, make_database(false));
+
+    std::vector<std::string> const files{ input.string() };
+    reader::cache_options options;
+    options.snapshot = snapshot.string();
+
+    // A snapshot that is rewritten gets a new write time, one that is loaded keeps the old one.
+    auto const stale = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24);
+
+    auto loaded = [&]
+    {
+        std::filesystem::last_write_time(snapshot, stale);
+        reader::cache const c{ files, options };
+        reader::cache const expected{ files };
+        require_equal(c, expected);
+        return std::filesystem::last_write_time(snapshot) == stale;
+    };
+
+    {
+        reader::cache const c{ files, options };
+        REQUIRE(std::filesystem::is_regular_file(snapshot));
+        require_equal(c, reader::cache{ files });
+    }
+
+    auto const saved = read_file(snapshot);
+
+    SECTION("round trip")
+    {
+        REQUIRE(loaded());
+        REQUIRE(loaded());
+        REQUIRE(read_file(snapshot) == saved);
+
+        options.parallel = true;
+        REQUIRE(loaded());
+    }
+
+    SECTION("write time")
+    {
+        std::filesystem::last_write_time(input, std::filesystem::last_write_time(input) + std::chrono::hours(1));
+        REQUIRE(!loaded());
+        REQUIRE(loaded());
+    }
+
+    SECTION("size")
+    {
+        auto const time = std::filesystem::last_write_time(input);
+        write_file(input, make_database(true));
+        std::filesystem::last_write_time(input, time);
+        REQUIRE(!loaded());
+        REQUIRE(reader::cache{ files, options }.find("Ns", "D"));
+        REQUIRE(loaded());
+    }
+
+    SECTION("rewritten")
+    {
+        auto const time = std::filesystem::last_write_time(input);
+        write_file(input, make_database(false, 2));
+        std::filesystem::last_write_time(input, time);
+        REQUIRE(!loaded());
+        REQUIRE(loaded());
+    }
+
+    SECTION("inputs")
+    {
+        auto const other = folder / "b.winmd";
+        write_file(other, make_database(false));
+        reader::cache const c{ std::vector<std::string>{ other.string() }, options };
+        REQUIRE(c.find("Ns", "C"));
+        REQUIRE(read_file(snapshot) != saved);
+    }
+
+    SECTION("checksum")
+    {
+        // The snapshot ends with the 16 (parent, type hash, row) slots of the attribute index. Changing
+        // the type hash of the one occupied slot still reads back cleanly, but would make
+        // Ns.MarkerAttribute unreachable.
+        auto damaged = saved;
+
+        for (auto offset = damaged.size() - 16 * 24; offset != damaged.size(); offset += 24)
+        {
+            if (damaged[offset + 16])
+            {
+                damaged[offset + 8] ^= 1;
+            }
+        }
+
+        REQUIRE(damaged != saved);
+        write_file(snapshot, damaged);
+        REQUIRE(!loaded());
+        REQUIRE(read_file(snapshot) == saved);
+    }
+
+    SECTION("truncated")
+    {
+        for (std::size_t size : { std::size_t{}, std::size_t{ 8 }, std::size_t{ 16 }, saved.size() / 2, saved.size() - 1 })
+        {
+            write_file(snapshot, { saved.begin(), saved.begin() + size });
+            REQUIRE(!loaded());
+            REQUIRE(read_file(snapshot) == saved);
+        }
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("cache deferred")
+{
+    auto const image = make_database(true);
+    std::vector<reader::byte_view> const files{ { image.data(), image.data() + image.size() } };
+    reader::cache_options options;
+    options.parallel = true;
+    options.deferred = true;
+
+    SECTION("categories")
+    {
+        reader::cache const c{ files, options };
+
+        // Namespaces are categorized on first use, from as many threads as ask at once.
+        xlang::task_group group;
+
+        for (auto&&[namespace_name, members] : c.namespaces())
+        {
+            for (int i{}; i != 4; ++i)
+            {
+                group.add([&members = members]
+                {
+                    members.interfaces();
+                });
+            }
+        }
+
+        group.get();
+        require_equal(c, reader::cache{ files });
+    }
+
+    SECTION("remove_type")
+    {
+        reader::cache c{ files, options };
+        c.remove_type("Ns", "D");
+        auto const& members = c.namespaces().at("Ns");
+        REQUIRE(get_names(members.interfaces()) == std::vector<std::string>{ "I" });
+        REQUIRE(get_names(members.classes()) == std::vector<std::string>{ "C" });
+    }
+}
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "meta_writer.h"
+
+using namespace xlang::meta;
+using namespace xlang::meta::writer;
+
+namespace
+{
+    // Builds a module with types Ns.A and Ns.B, where A has a field and a method, after letting
+    // update replace the values of any row before it is added.
+    template <typename F>
+    std::vector<uint8_t> make_database(F&& update)
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+        auto const field_signature = w.blobs().add(std::vector<uint8_t>{ 0x06, 0x08 });
+        auto const method_signature = w.blobs().add(std::vector<uint8_t>{ 0x20, 0x00, 0x01 });
+
+        auto add = [&](table_id const table, std::vector<uint32_t> values)
+        {
+            update(table, values);
+            w.add_row(table, values);
+        };
+
+        add(table_id::Module, { 0, strings.add("a.winmd"), 0, 0, 0 });
+        add(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        add(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        add(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+        add(table_id::TypeDef, { 0x1, strings.add("A"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+        add(table_id::TypeDef, { 0x1, strings.add("B"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 2, 2 });
+        add(table_id::Field, { 0x6, strings.add("f"), field_signature });
+        add(table_id::MethodDef, { 0, 0, 0x6, strings.add("M"), method_signature, 1 });
+        add(table_id::NestedClass, { 3, 2 });
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    std::vector<uint8_t> make_database()
+    {
+        return make_database([](table_id, std::vector<uint32_t>&) {});
+    }
+
+    // Returns the image with the value in the given column of a row, counted from one, replaced.
+    std::vector<uint8_t> make_database(table_id const table, uint32_t const row, uint32_t const column, uint32_t const value)
+    {
+        uint32_t current{};
+
+        return make_database([&](table_id const id, std::vector<uint32_t>& values)
+        {
+            if (id == table && ++current == row)
+            {
+                values[column] = value;
+            }
+        });
+    }
+}
+
+TEST_CASE("database")
+{
+    SECTION("valid")
+    {
+        reader::database db{ make_database() };
+        REQUIRE(db.TypeDef.size() == 3);
+        REQUIRE(db.TypeDef[1].FieldList().first.Name() == "f");
+        REQUIRE(db.NestedClass.size() == 1);
+    }
+
+    SECTION("index out of range")
+    {
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::NestedClass, 1, 0, 0) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::NestedClass, 1, 0, 4) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::NestedClass, 1, 1, 100) }, std::invalid_argument);
+    }
+
+    SECTION("list out of range")
+    {
+        // Lists may end one past the last row but not further, and may not run backwards.
+        REQUIRE_NOTHROW(reader::database{ make_database(table_id::TypeDef, 3, 5, 2) });
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 3, 5, 3) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 3, 4, 3) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 2, 4, 0) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 1, 4, 2) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::MethodDef, 1, 5, 2) }, std::invalid_argument);
+    }
+
+    SECTION("coded index out of range")
+    {
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeRef, 1, 0, scope.encode(table_id::AssemblyRef, 2)) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 2, 3, type.encode(table_id::TypeRef, 2)) }, std::invalid_argument);
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 2, 3, type.encode(table_id::TypeSpec, 1)) }, std::invalid_argument);
+
+        // TypeDefOrRef has two tag bits but only three tables.
+        REQUIRE_THROWS_AS(reader::database{ make_database(table_id::TypeDef, 2, 3, (1 << 2) | 3) }, std::invalid_argument);
+    }
+
+    SECTION("truncated")
+    {
+        auto const image = make_database();
+
+        for (std::size_t size{}; size < image.size(); ++size)
+        {
+            std::vector<uint8_t> truncated(image.begin(), image.begin() + size);
+            bool valid{};
+
+            try
+            {
+                reader::database db{ std::move(truncated) };
+                valid = true;
+            }
+            catch (std::invalid_argument const&)
+            {
+            }
+
+            INFO("size " << size << " of " << image.size());
+            REQUIRE(!valid);
+        }
+    }
+}
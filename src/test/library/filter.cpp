@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "meta_reader.h"
+
+using namespace xlang::meta::reader;
+
+TEST_CASE("filter")
+{
+    using rules = std::vector<std::string>;
+
+    SECTION("empty")
+    {
+        filter f;
+        REQUIRE(f.empty());
+        REQUIRE(f.includes("Ns.A"));
+    }
+
+    SECTION("longest match")
+    {
+        filter f{ rules{ "Windows", "Windows.UI.Xaml.Controls.Button" }, rules{ "Windows.UI", "Windows.Foundation.Uri" } };
+        REQUIRE(!f.empty());
+        REQUIRE(f.includes("Windows.Foundation.IAsyncAction"));
+        REQUIRE(!f.includes("Windows.Foundation.Uri"));
+        REQUIRE(!f.includes("Windows.Foundation.UriRuntimeClass"));
+        REQUIRE(!f.includes("Windows.UI.Colors"));
+        REQUIRE(!f.includes("Windows.UI.Xaml.Controls.Grid"));
+        REQUIRE(f.includes("Windows.UI.Xaml.Controls.Button"));
+        REQUIRE(f.includes("Windows.UI.Xaml.Controls.ButtonBase"));
+        REQUIRE(!f.includes("System.Object"));
+    }
+
+    SECTION("partial segment")
+    {
+        filter f{ rules{ "Windows.Found" }, rules{} };
+        REQUIRE(f.includes("Windows.Foundation.Uri"));
+        REQUIRE(!f.includes("Windows.UI.Colors"));
+    }
+
+    SECTION("exclude wins")
+    {
+        filter f{ rules{ "Ns", "Ns.A" }, rules{ "Ns.A" } };
+        REQUIRE(!f.includes("Ns.A"));
+        REQUIRE(f.includes("Ns.B"));
+    }
+}
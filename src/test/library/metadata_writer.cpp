@@ -0,0 +1,393 @@
+#include "pch.h"
+#include "meta_writer.h"
+#include <random>
+
+using namespace xlang::meta;
+using namespace xlang::meta::writer;
+
+namespace
+{
+    // Builds a module with types Ns.A and Ns.B, both deriving from System.Object, where A has a
+    // method M(Ns.B).
+    std::vector<uint8_t> make_database(std::string_view const& name)
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        uint8_t const mvid[16]{ 1, 2, 3 };
+
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+
+        w.add_row(table_id::Module, { 0, strings.add(std::string{ name } + ".winmd"), w.guids().add(mvid), 0, 0 });
+        w.add_row(table_id::Assembly, { 0x8004, 0, 0, 0, strings.add(name), 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        w.add_row(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x1, strings.add("A"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x1, strings.add("B"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 2 });
+
+        // HasThis, one parameter, void return, Class <TypeDef 3>
+        std::vector<uint8_t> const signature{ 0x20, 0x01, 0x01, 0x12, static_cast<uint8_t>(type.encode(table_id::TypeDef, 3)) };
+        w.add_row(table_id::MethodDef, { 0, 0, 0x0006, strings.add("M"), w.blobs().add(signature), 1 });
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    // Builds a module b with type Ns.C deriving from Ns.A in module a, with an attribute whose
+    // constructor is a MemberRef to Ns.A.M(Ns.B).
+    std::vector<uint8_t> make_referencing_database()
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        uint8_t const mvid[16]{ 4, 5, 6 };
+
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+        auto const& parent = get_coded_index_schema(coded_index_id::MemberRefParent);
+        auto const& attributed = get_coded_index_schema(coded_index_id::HasCustomAttribute);
+        auto const& constructor = get_coded_index_schema(coded_index_id::CustomAttributeType);
+
+        w.add_row(table_id::Module, { 0, strings.add("b.winmd"), w.guids().add(mvid), 0, 0 });
+        w.add_row(table_id::Assembly, { 0x8004, 0, 0, 0, strings.add("b"), 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("a"), 0, 0 });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 2), strings.add("A"), strings.add("Ns") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 2), strings.add("B"), strings.add("Ns") });
+        w.add_row(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x1, strings.add("C"), strings.add("Ns"), type.encode(table_id::TypeRef, 2), 1, 1 });
+
+        // HasThis, one parameter, void return, Class <TypeRef 3>
+        std::vector<uint8_t> const signature{ 0x20, 0x01, 0x01, 0x12, static_cast<uint8_t>(type.encode(table_id::TypeRef, 3)) };
+        w.add_row(table_id::MemberRef, { parent.encode(table_id::TypeRef, 2), strings.add("M"), w.blobs().add(signature) });
+        w.add_row(table_id::CustomAttribute, { attributed.encode(table_id::TypeDef, 2), constructor.encode(table_id::MemberRef, 1), 0 });
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    // Builds a module defining Ns.Outer with nested type Inner, and, if user is not empty, a type
+    // with that name whose method takes Inner.
+    std::vector<uint8_t> make_nested_database(std::string_view const& name, std::string_view const& user)
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        uint8_t const mvid[16]{ 7 };
+
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+
+        w.add_row(table_id::Module, { 0, strings.add(std::string{ name } + ".winmd"), w.guids().add(mvid), 0, 0 });
+        w.add_row(table_id::Assembly, { 0x8004, 0, 0, 0, strings.add(name), 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        w.add_row(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x1, strings.add("Outer"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+        w.add_row(table_id::TypeDef, { 0x2, strings.add("Inner"), 0, type.encode(table_id::TypeRef, 1), 1, 1 });
+        w.add_row(table_id::NestedClass, { 3, 2 });
+
+        if (!user.empty())
+        {
+            // HasThis, one parameter, void return, Class <TypeDef 3>
+            std::vector<uint8_t> const signature{ 0x20, 0x01, 0x01, 0x12, static_cast<uint8_t>(type.encode(table_id::TypeDef, 3)) };
+            w.add_row(table_id::TypeDef, { 0x1, strings.add(user), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+            w.add_row(table_id::MethodDef, { 0, 0, 0x0006, strings.add("M"), w.blobs().add(signature), 1 });
+        }
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    // Builds one of two modules for the walker test. Module a defines Ns.Root, whose generic
+    // parameter is constrained to Ns.Constraint in module b, and Ns.Unused. Module b defines
+    // Ns.Constraint and Ns.Other, which derives from Ns.Unused.
+    std::vector<uint8_t> make_walker_database(std::string_view const& name)
+    {
+        metadata_writer w;
+        auto& strings = w.strings();
+        uint8_t const mvid[16]{ 8 };
+        auto const first = name == "a";
+
+        auto const& scope = get_coded_index_schema(coded_index_id::ResolutionScope);
+        auto const& type = get_coded_index_schema(coded_index_id::TypeDefOrRef);
+        auto const& owner = get_coded_index_schema(coded_index_id::TypeOrMethodDef);
+
+        w.add_row(table_id::Module, { 0, strings.add(std::string{ name } + ".winmd"), w.guids().add(mvid), 0, 0 });
+        w.add_row(table_id::Assembly, { 0x8004, 0, 0, 0, strings.add(name), 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add("mscorlib"), 0, 0 });
+        w.add_row(table_id::AssemblyRef, { 0, 0, 0, strings.add(first ? "b" : "a"), 0, 0 });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 1), strings.add("Object"), strings.add("System") });
+        w.add_row(table_id::TypeRef, { scope.encode(table_id::AssemblyRef, 2), strings.add(first ? "Constraint" : "Unused"), strings.add("Ns") });
+        w.add_row(table_id::TypeDef, { 0, strings.add("<Module>"), 0, 0, 1, 1 });
+
+        if (first)
+        {
+            w.add_row(table_id::TypeDef, { 0x40a1, strings.add("Root"), strings.add("Ns"), 0, 1, 1 });
+            w.add_row(table_id::TypeDef, { 0x4101, strings.add("Unused"), strings.add("Ns"), type.encode(table_id::TypeRef, 1), 1, 1 });
+            w.add_row(table_id::GenericParam, { 0, 0, owner.encode(table_id::TypeDef, 2), strings.add("T") });
+            w.add_row(table_id::GenericParamConstraint, { 1, type.encode(table_id::TypeRef, 2) });
+        }
+        else
+        {
+            w.add_row(table_id::TypeDef, { 0x40a1, strings.add("Constraint"), strings.add("Ns"), 0, 1, 1 });
+            w.add_row(table_id::TypeDef, { 0x4101, strings.add("Other"), strings.add("Ns"), type.encode(table_id::TypeRef, 2), 1, 1 });
+        }
+
+        pe_writer pe;
+        pe.add_metadata(w.save());
+        return pe.save_to_memory();
+    }
+
+    std::string parameter_type(reader::database const& db)
+    {
+        auto const method = db.MethodDef[0];
+        auto const signature = method.Signature();
+        auto const& param = *begin(signature.Params());
+        auto const index = std::get<reader::coded_index<reader::TypeDefOrRef>>(param.Type().Type());
+
+        if (index.type() == reader::TypeDefOrRef::TypeDef)
+        {
+            auto const definition = index.TypeDef();
+            return "def:" + std::string{ definition.TypeNamespace() } + "." + std::string{ definition.TypeName() };
+        }
+
+        auto const reference = index.TypeRef();
+        return "ref:" + std::string{ reference.TypeNamespace() } + "." + std::string{ reference.TypeName() };
+    }
+}
+
+TEST_CASE("metadata_writer")
+{
+    reader::database db{ make_database("a") };
+
+    REQUIRE(db.TypeDef.size() == 3);
+    REQUIRE(db.TypeDef[1].TypeName() == "A");
+    REQUIRE(db.TypeDef[1].MethodList().first.Name() == "M");
+    REQUIRE(db.TypeDef[1].Extends().TypeRef().TypeName() == "Object");
+    REQUIRE(parameter_type(db) == "def:Ns.B");
+
+    // Cached signatures decode the same as parsed ones, including on repeated calls.
+    db.enable_signature_cache();
+    REQUIRE(parameter_type(db) == "def:Ns.B");
+    REQUIRE(parameter_type(db) == "def:Ns.B");
+    REQUIRE(size(db.MethodDef[0].Signature().Params()) == 1);
+}
+
+TEST_CASE("pe_writer")
+{
+    // A name unique to this run so that concurrent test runs don't share the file.
+    std::random_device random;
+    auto const path = std::filesystem::temp_directory_path() /
+        ("xlang_test_pe_writer_" + std::to_string(random()) + "_" + std::to_string(random()) + ".winmd");
+
+    auto save = [](pe_writer& pe)
+    {
+        metadata_writer w;
+        w.add_row(table_id::Module, { 0, w.strings().add("a.winmd"), 0, 0, 0 });
+        w.add_row(table_id::TypeDef, { 0, w.strings().add("<Module>"), 0, 0, 1, 1 });
+
+        // Enough rows and strings to span several chunks.
+        for (int i = 0; i < 2000; ++i)
+        {
+            w.add_row(table_id::TypeDef, { 0x1, w.strings().add("T" + std::to_string(i)), w.strings().add("Ns"), 0, 1, 1 });
+        }
+
+        pe.add_metadata(w.save());
+    };
+
+    std::vector<uint8_t> expected;
+
+    {
+        pe_writer pe;
+        save(pe);
+        expected = pe.save_to_memory();
+    }
+
+    {
+        pe_writer pe;
+        save(pe);
+        pe.save_to_file(path);
+    }
+
+    {
+        auto temp = path;
+        temp += ".tmp";
+        REQUIRE(!std::filesystem::exists(temp));
+
+        // A file that cannot be written leaves nothing behind.
+        auto const missing = path.parent_path() / "missing" / path.filename();
+        pe_writer pe;
+        save(pe);
+        REQUIRE_THROWS(pe.save_to_file(missing));
+        REQUIRE(!std::filesystem::exists(missing.parent_path()));
+    }
+
+    {
+        std::ifstream file{ path, std::ios::binary };
+        std::vector<uint8_t> const actual{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        REQUIRE(actual == expected);
+    }
+
+    {
+        reader::database db{ path.string() };
+        REQUIRE(db.Module[0].Name() == "a.winmd");
+        REQUIRE(db.TypeDef.size() == 2001);
+        REQUIRE(db.TypeDef[2000].TypeName() == "T1999");
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("merge_writer")
+{
+    reader::database a{ make_database("a") };
+    reader::database b{ make_database("b") };
+
+    SECTION("duplicates")
+    {
+        merge_writer merge{ "merged" };
+        merge.add(a);
+        merge.add(b);
+        reader::database db{ merge.save_to_memory() };
+
+        REQUIRE(db.Module[0].Name() == "merged.winmd");
+        REQUIRE(db.TypeDef.size() == 3);
+        REQUIRE(db.MethodDef.size() == 1);
+        REQUIRE(db.AssemblyRef.size() == 1);
+        REQUIRE(parameter_type(db) == "def:Ns.B");
+    }
+
+    SECTION("filter")
+    {
+        merge_writer merge{ "merged" };
+        merge.add(a);
+        merge.filter([](reader::TypeDef const& type)
+        {
+            return type.TypeName() != "B";
+        });
+
+        reader::database db{ merge.save_to_memory() };
+
+        REQUIRE(db.TypeDef.size() == 2);
+        REQUIRE(db.TypeDef[1].TypeName() == "A");
+        REQUIRE(parameter_type(db) == "ref:Ns.B");
+        REQUIRE(db.AssemblyRef.size() == 2);
+        REQUIRE(db.AssemblyRef[1].Name() == "a");
+    }
+
+    SECTION("references")
+    {
+        reader::database c{ make_referencing_database() };
+        merge_writer merge{ "merged" };
+        merge.add(a);
+        merge.add(c);
+        reader::database db{ merge.save_to_memory() };
+
+        REQUIRE(db.TypeDef.size() == 4);
+        REQUIRE(db.TypeDef[3].TypeName() == "C");
+        REQUIRE(db.TypeDef[3].Extends().type() == reader::TypeDefOrRef::TypeDef);
+        REQUIRE(db.TypeDef[3].Extends().TypeDef().TypeName() == "A");
+
+        for (auto&& assembly : db.AssemblyRef)
+        {
+            REQUIRE(assembly.Name() != "a");
+        }
+
+        for (auto&& type : db.TypeRef)
+        {
+            REQUIRE(type.TypeNamespace() != "Ns");
+        }
+
+        REQUIRE(db.MemberRef.size() == 0);
+        REQUIRE(db.CustomAttribute.size() == 1);
+        REQUIRE(db.CustomAttribute[0].Type().type() == reader::CustomAttributeType::MethodDef);
+        REQUIRE(db.CustomAttribute[0].Type().MethodDef().Name() == "M");
+        REQUIRE(db.CustomAttribute[0].Parent().type() == reader::HasCustomAttribute::TypeDef);
+        REQUIRE(db.CustomAttribute[0].Parent().index() == 3);
+    }
+
+    SECTION("nested duplicates")
+    {
+        reader::database first{ make_nested_database("first", "") };
+        reader::database second{ make_nested_database("second", "User") };
+        merge_writer merge{ "merged" };
+        merge.add(first);
+        merge.add(second);
+        reader::database db{ merge.save_to_memory() };
+
+        REQUIRE(db.TypeDef.size() == 4);
+        REQUIRE(db.NestedClass.size() == 1);
+        REQUIRE(db.TypeRef.size() == 2);
+        REQUIRE(db.TypeDef[3].TypeName() == "User");
+
+        auto const signature = db.MethodDef[0].Signature();
+        auto const& param = *begin(signature.Params());
+        auto const index = std::get<reader::coded_index<reader::TypeDefOrRef>>(param.Type().Type());
+        REQUIRE(index.type() == reader::TypeDefOrRef::TypeDef);
+        REQUIRE(index.TypeDef().TypeName() == "Inner");
+        REQUIRE(index.TypeDef().index() == 2);
+    }
+}
+
+TEST_CASE("type_walker")
+{
+    auto const a = make_walker_database("a");
+    auto const b = make_walker_database("b");
+    std::vector<std::pair<std::string, reader::byte_view>> const files
+    {
+        { "a.winmd", { a.data(), a.data() + a.size() } },
+        { "b.winmd", { b.data(), b.data() + b.size() } }
+    };
+
+    reader::cache c{ files };
+    REQUIRE(c.databases().front().path() == "a.winmd");
+    REQUIRE(c.databases().back().path() == "b.winmd");
+
+    type_walker walker{ c };
+
+    for (auto&& db : c.databases())
+    {
+        walker.add_input(db);
+    }
+
+    walker.add(c.find("Ns", "Root"));
+    walker.run();
+
+    REQUIRE(walker.names() == std::set<std::string>{ "Ns.Constraint", "Ns.Root" });
+
+    merge_writer merge{ "merged" };
+    merge.filter([&](reader::TypeDef const& type)
+    {
+        return walker.includes(type);
+    });
+
+    for (auto&& db : c.databases())
+    {
+        merge.add(db);
+    }
+
+    reader::database db{ merge.save_to_memory() };
+    std::vector<std::string> types;
+
+    for (auto&& type : db.TypeDef)
+    {
+        types.push_back(std::string{ type.TypeNamespace() } + "." + std::string{ type.TypeName() });
+    }
+
+    REQUIRE(types == std::vector<std::string>{ ".<Module>", "Ns.Root", "Ns.Constraint" });
+
+    // Nothing refers to the types that were left out or to the merged inputs, and the references
+    // to System.Object were only made by types that were left out.
+    REQUIRE(db.TypeRef.size() == 0);
+    REQUIRE(db.AssemblyRef.size() == 0);
+
+    REQUIRE(db.GenericParamConstraint.size() == 1);
+    auto const constraint = db.GenericParamConstraint[0].Constraint();
+    REQUIRE(constraint.type() == reader::TypeDefOrRef::TypeDef);
+    REQUIRE(constraint.TypeDef().TypeName() == "Constraint");
+    REQUIRE(db.GenericParam[0].GenericParamConstraint().first.Constraint().TypeDef().TypeName() == "Constraint");
+}
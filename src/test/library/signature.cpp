@@ -0,0 +1,133 @@
+#include "catch.hpp"
+#include "pch.h"
+#include "meta_reader.h"
+
+using namespace xlang::meta::reader;
+
+namespace
+{
+    std::atomic<std::size_t> heap_allocations{};
+    std::atomic<std::size_t> heap_deallocations{};
+}
+
+// Counts heap traffic so that the tests can check what the signature pool saves.
+void* operator new(std::size_t const size)
+{
+    ++heap_allocations;
+
+    if (auto result = std::malloc(size ? size : 1))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const pointer) noexcept
+{
+    if (pointer)
+    {
+        ++heap_deallocations;
+    }
+
+    std::free(pointer);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace
+{
+    uint8_t const method_blob[]
+    {
+        0x20, // HasThis
+        0x03, // Param count
+        0x01, // Void
+        0x08, // I4
+        0x1d, 0x0e, // SZArray String
+        0x15, 0x12, 0x05, 0x02, 0x08, 0x13, 0x00, // GenericInst Class <TypeRef 1> <I4, Var 0>
+    };
+}
+
+TEST_CASE("signature")
+{
+    auto const& blob = method_blob;
+
+    // Parse repeatedly so that later iterations reuse storage recycled by earlier ones.
+    for (int i = 0; i < 3; ++i)
+    {
+        byte_view data{ std::begin(blob), std::end(blob) };
+        MethodDefSig signature{ nullptr, data };
+
+        REQUIRE(data.size() == 0);
+        REQUIRE(signature.CallConvention() == CallingConvention::HasThis);
+        REQUIRE(!signature.ReturnType());
+        REQUIRE(size(signature.Params()) == 3);
+
+        auto param = begin(signature.Params());
+        REQUIRE(std::get<ElementType>(param->Type().Type()) == ElementType::I4);
+
+        ++param;
+        REQUIRE(param->Type().is_szarray());
+        REQUIRE(std::get<ElementType>(param->Type().Type()) == ElementType::String);
+
+        ++param;
+        auto const& generic = std::get<GenericTypeInstSig>(param->Type().Type());
+        REQUIRE(generic.GenericType().type() == TypeDefOrRef::TypeRef);
+        REQUIRE(generic.GenericArgCount() == 2);
+        REQUIRE(std::get<ElementType>(begin(generic.GenericArgs())->Type()) == ElementType::I4);
+        REQUIRE(std::get<GenericTypeIndex>((begin(generic.GenericArgs()) + 1)->Type()).index == 0);
+    }
+}
+
+TEST_CASE("signature_pool")
+{
+    auto parse = []
+    {
+        byte_view data{ std::begin(method_blob), std::end(method_blob) };
+        MethodDefSig signature{ nullptr, data };
+        return size(signature.Params());
+    };
+
+    SECTION("reuse")
+    {
+        // Warm up the current thread's free lists.
+        parse();
+
+        auto const before = heap_allocations.load();
+        std::size_t params{};
+
+        for (int i = 0; i < 100; ++i)
+        {
+            params += parse();
+        }
+
+        auto const after = heap_allocations.load();
+        REQUIRE(params == 300);
+        REQUIRE(after == before);
+    }
+
+    SECTION("bounded")
+    {
+        xlang::impl::signature_allocator<uint64_t> allocator;
+        std::vector<uint64_t*> blocks;
+        blocks.reserve(10000);
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            blocks.push_back(allocator.allocate(2));
+        }
+
+        auto const before = heap_deallocations.load();
+
+        for (auto block : blocks)
+        {
+            allocator.deallocate(block, 2);
+        }
+
+        // Most of the blocks go back to the heap once the free list is full.
+        REQUIRE(heap_deallocations.load() - before > 9000);
+    }
+}
@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "task_group.h"
+
+using namespace xlang;
+
+TEST_CASE("task_group")
+{
+    SECTION("runs every task")
+    {
+        std::atomic<int> count{};
+        task_group group;
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            group.add([&] { ++count; });
+        }
+
+        group.get();
+        REQUIRE(count == 1000);
+    }
+
+    SECTION("nested groups")
+    {
+        std::atomic<int> count{};
+        task_group outer;
+
+        for (int i = 0; i < 64; ++i)
+        {
+            outer.add([&]
+            {
+                task_group inner;
+
+                for (int j = 0; j < 64; ++j)
+                {
+                    inner.add([&] { ++count; });
+                }
+
+                inner.get();
+            });
+        }
+
+        outer.get();
+        REQUIRE(count == 64 * 64);
+    }
+
+    SECTION("rethrows")
+    {
+        std::atomic<int> count{};
+        task_group group;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            group.add([&, i]
+            {
+                ++count;
+
+                if (i == 7)
+                {
+                    throw std::invalid_argument("task failed");
+                }
+            });
+        }
+
+        REQUIRE_THROWS_AS(group.get(), std::invalid_argument);
+        REQUIRE(count == 16);
+    }
+}
+
+TEST_CASE("task_group options")
+{
+    SECTION("jobs")
+    {
+        REQUIRE(get_task_group_options("4").jobs == 4);
+        REQUIRE(!get_task_group_options("4").jobserver);
+        REQUIRE(get_task_group_options("").jobserver);
+        REQUIRE_THROWS_AS(get_task_group_options("0"), std::invalid_argument);
+        REQUIRE_THROWS_AS(get_task_group_options("x"), std::invalid_argument);
+        REQUIRE_THROWS_AS(get_task_group_options("4x"), std::invalid_argument);
+    }
+
+    SECTION("configure")
+    {
+        auto const previous = impl::thread_pool::options();
+        task_group_options options;
+        options.jobs = 3;
+        options.jobserver = true;
+        task_group::configure(options);
+        REQUIRE(impl::thread_pool::options().jobs == 3);
+        REQUIRE(impl::thread_pool::options().jobserver);
+        task_group::configure(previous);
+    }
+}
+
+TEST_CASE("task_group jobserver")
+{
+    using impl::jobserver;
+
+    SECTION("auth")
+    {
+        REQUIRE(jobserver::get_auth("") == "");
+        REQUIRE(jobserver::get_auth("-j8") == "");
+        REQUIRE(jobserver::get_auth(" -j8 --jobserver-auth=3,4") == "3,4");
+        REQUIRE(jobserver::get_auth(" -j8 --jobserver-fds=5,6 -- X=1") == "5,6");
+        REQUIRE(jobserver::get_auth("-j --jobserver-auth=fifo:/tmp/GMfifo1") == "fifo:/tmp/GMfifo1");
+        REQUIRE(jobserver::get_auth("--jobserver-auth=3,4 --jobserver-fds=5,6") == "5,6");
+        REQUIRE(jobserver::get_auth("--jobserver-fds=5,6 --jobserver-auth=3,4") == "3,4");
+        REQUIRE(jobserver::get_auth("--jobserver-auth=3,4 --jobserver-auth=7,8") == "7,8");
+    }
+
+    SECTION("invalid")
+    {
+        REQUIRE(!jobserver::open(""));
+        REQUIRE(!jobserver::open("--jobserver-auth="));
+        REQUIRE(!jobserver::open("--jobserver-auth=x"));
+        REQUIRE(!jobserver::open("--jobserver-auth=-1,-1"));
+    }
+
+#if !XLANG_PLATFORM_WINDOWS
+    SECTION("pipe")
+    {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        REQUIRE(write(fds[1], "++", 2) == 2);
+        auto const makeflags = " -j3 --jobserver-auth=" + std::to_string(fds[0]) + "," + std::to_string(fds[1]);
+
+        // Without /proc the jobserver is not used rather than risking a blocking read.
+        if (auto server = jobserver::open(makeflags))
+        {
+            auto const first = server->acquire(std::chrono::milliseconds{ 10 });
+            auto const second = server->acquire(std::chrono::milliseconds{ 10 });
+            REQUIRE(first == '+');
+            REQUIRE(second == '+');
+            REQUIRE(!server->acquire(std::chrono::milliseconds{ 10 }));
+            server->release(*first);
+            REQUIRE(server->acquire(std::chrono::milliseconds{ 10 }) == '+');
+            server->release(*first);
+            server->release(*second);
+        }
+
+        char buffer[2];
+        REQUIRE(read(fds[0], buffer, 2) == 2);
+        REQUIRE((fcntl(fds[0], F_GETFL) & O_NONBLOCK) == 0);
+        close(fds[0]);
+        close(fds[1]);
+    }
+#endif
+}
@@ -18,3 +18,190 @@ TEST_CASE("writer")
 
     REQUIRE(w.flush_to_string() == "pre 123 % String post");
 }
+
+TEST_CASE("writer format")
+{
+    static constexpr xlang::text::format format{ "%^%% ^^@ %" };
+    static_assert(format.placeholders() == 4);
+    static_assert(format.end() - format.begin() == 8);
+
+    writer w;
+    w.write(format, 1, 2, "code", 'c');
+
+    REQUIRE(w.flush_to_string() == "1%2 ^code c");
+
+    // Long format strings don't need a segment per character.
+    static constexpr xlang::text::format long_format{ R"(
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+%)" };
+    static_assert(decltype(long_format)::capacity == 128);
+    static_assert(sizeof(long_format) < 128 * sizeof(*long_format.begin()) + 64);
+    static_assert(long_format.end() - long_format.begin() == 2);
+}
+
+TEST_CASE("writer blocks")
+{
+    std::string const line(1000, 'x');
+    std::string expected;
+    writer w;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        w.write("%\n", line);
+        expected += line + '\n';
+
+        REQUIRE(w.write_temp("[%]", i) == "[" + std::to_string(i) + "]");
+    }
+
+    REQUIRE(w.back() == '\n');
+    REQUIRE(w.flush_to_string() == expected);
+}
+
+TEST_CASE("writer stream")
+{
+    auto const path = (std::filesystem::temp_directory_path() / "xlang_test_writer_stream.txt").string();
+    std::string const line(1000, 'x');
+    std::string body;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        body += line + '\n';
+    }
+
+    auto read = [&]
+    {
+        std::ifstream file{ path, std::ios::binary };
+        return std::string{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    };
+
+    SECTION("in order")
+    {
+        writer w;
+        w.stream_to_file(path);
+        w.write(body);
+        w.flush_to_file(path);
+
+        REQUIRE(read() == body);
+        REQUIRE(!std::filesystem::exists(path + ".tmp"));
+    }
+
+    SECTION("prefix")
+    {
+        writer w;
+        w.stream_to_file(path);
+        w.write(body);
+        w.swap();
+        w.write("prefix\n");
+        w.flush_to_file(path);
+
+        REQUIRE(read() == "prefix\n" + body);
+        REQUIRE(!std::filesystem::exists(path + ".tmp"));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("writer manifest")
+{
+    auto const folder = std::filesystem::temp_directory_path();
+    auto const path = (folder / "xlang_test_writer_manifest.txt").string();
+    auto const manifest_path = (folder / "xlang_test_writer_manifest.manifest").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(manifest_path);
+
+    auto hash = [](std::string_view const& text, std::size_t const chunk)
+    {
+        xlang::impl::content_hash result;
+
+        for (std::size_t offset{}; offset < text.size(); offset += chunk)
+        {
+            result.update(text.data() + offset, std::min(chunk, text.size() - offset));
+        }
+
+        return result.value();
+    };
+
+    std::string_view const text{ "The quick brown fox jumps over the lazy dog" };
+    REQUIRE(hash(text, 1) == hash(text, text.size()));
+    REQUIRE(hash(text, 3) == hash(text, 8));
+    REQUIRE(hash(text, 5) != hash(text.substr(1), 5));
+
+    auto write = [&](std::string_view const& content)
+    {
+        writer w;
+        w.write(content);
+        w.flush_to_file(path);
+    };
+
+    {
+        xlang::text::output_manifest manifest{ manifest_path };
+        xlang::text::output_manifest::current() = &manifest;
+        REQUIRE(!manifest.check(path, text.size(), hash(text, 1)));
+
+        write(text);
+        REQUIRE(manifest.check(path, text.size(), hash(text, 1)) == true);
+        REQUIRE(manifest.check(path, text.size(), hash("other", 1)) == false);
+        manifest.save();
+        xlang::text::output_manifest::current() = nullptr;
+    }
+
+    {
+        xlang::text::output_manifest manifest{ manifest_path };
+        xlang::text::output_manifest::current() = &manifest;
+        REQUIRE(manifest.check(path, text.size(), hash(text, 1)) == true);
+
+        write("changed");
+        REQUIRE(manifest.check(path, 7, hash("changed", 1)) == true);
+
+        {
+            std::ofstream file{ path, std::ios::binary };
+            file << "edited outside";
+        }
+
+        REQUIRE(!manifest.check(path, 7, hash("changed", 1)));
+        write("changed");
+        xlang::text::output_manifest::current() = nullptr;
+    }
+
+    std::ifstream file{ path, std::ios::binary };
+    REQUIRE(std::string{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() } == "changed");
+    file.close();
+
+    // Streamed text is hashed as its blocks are written out.
+    std::string const body(300 * 1024, 'x');
+
+    auto stream = [&](std::string_view const& prefix)
+    {
+        writer w;
+        w.stream_to_file(path);
+        w.write(body);
+
+        if (!prefix.empty())
+        {
+            w.swap();
+            w.write(prefix);
+        }
+
+        w.flush_to_file(path);
+        return std::filesystem::last_write_time(path);
+    };
+
+    {
+        xlang::text::output_manifest manifest{ manifest_path };
+        xlang::text::output_manifest::current() = &manifest;
+
+        stream({});
+        REQUIRE(manifest.check(path, body.size(), hash(body, 4096)) == true);
+
+        auto const written = stream("prefix\n");
+        REQUIRE(manifest.check(path, body.size() + 7, 0) == false);
+        REQUIRE(stream("prefix\n") == written);
+        REQUIRE(std::filesystem::file_size(path) == body.size() + 7);
+        xlang::text::output_manifest::current() = nullptr;
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(manifest_path);
+}
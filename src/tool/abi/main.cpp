@@ -35,6 +35,8 @@ static constexpr option options[]
     { "enum-class", 0, 0, {}, "Use 'MIDL_ENUM', rather than 'enum'" },
     { "lowercase-include-guard", 0, 0, {}, "Generate lowercase include guards for compatibility with Windows SDK headers" },
     { "enable-header-deprecation", 0, 0, {}, "Generate support for [[deprecated(...)]] attribute" },
+    { "snapshot", 0, 1, "<path>", "Cache indexed metadata in a snapshot file to speed up later runs" },
+    { "jobs", 0, 1, "<count>", "Limit concurrent tasks (defaults to make jobserver or processor count)" },
     { "help", 0, option::no_max, {}, "Show detailed help with examples" },
 };
 
@@ -90,6 +92,8 @@ int main(int const argc, char** argv)
             throw usage_exception{};
         }
         
+        task_group::configure(get_task_group_options(args.value("jobs")));
+
         abi_configuration config;
         config.verbose = args.exists("verbose");
         config.output_directory = output_directory(args);
@@ -154,7 +158,11 @@ int main(int const argc, char** argv)
         filesToRead.insert(filesToRead.end(), inputFiles.begin(), inputFiles.end());
         filesToRead.insert(filesToRead.end(), referenceFiles.begin(), referenceFiles.end());
 
-        cache c{ filesToRead };
+        cache_options options;
+        options.parallel = true;
+        options.deferred = true;
+        options.snapshot = args.value("snapshot");
+        cache c{ filesToRead, options };
         metadata_cache mdCache{ c };
 
         auto include = args.values("include");
@@ -208,6 +216,7 @@ int main(int const argc, char** argv)
         };
 
         bool foundationDependency = false;
+        std::vector<std::pair<std::size_t, std::string_view>> namespacesToWrite;
         for (auto const& [ns, nsTypes] : mdCache.namespaces)
         {
             // Headers are all or nothing. If the consumer is wanting one type in a namespace, they get everything
@@ -219,14 +228,26 @@ int main(int const argc, char** argv)
                 }
                 else
                 {
-                    group.add([&, ns = ns]()
-                    {
-                        write_abi_header(ns, config, mdCache.compile_namespaces({ ns }));
-                    });
+                    auto members = c.namespaces().find(ns);
+                    namespacesToWrite.emplace_back(members == c.namespaces().end() ? 0 : estimate_size(members->second), ns);
                 }
             }
         }
 
+        // Start the largest headers first so that they are not left on the critical path
+        std::stable_sort(namespacesToWrite.begin(), namespacesToWrite.end(), [](auto const& lhs, auto const& rhs)
+        {
+            return lhs.first > rhs.first;
+        });
+
+        for (auto const& [estimate, ns] : namespacesToWrite)
+        {
+            group.add([&, ns = ns]()
+            {
+                write_abi_header(ns, config, mdCache.compile_namespaces({ ns }));
+            });
+        }
+
         if (foundationDependency)
         {
             group.add([&]()
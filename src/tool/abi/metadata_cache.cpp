@@ -55,8 +55,8 @@ void metadata_cache::process_namespace_types(
     // Mapped types are only in the 'Windows.Foundation' namespace, so pre-compute
     bool isFoundationNamespace = members.types.begin()->second.TypeNamespace() == foundation_namespace;
 
-    target.enums.reserve(members.enums.size());
-    for (auto const& e : members.enums)
+    target.enums.reserve(members.enums().size());
+    for (auto const& e : members.enums())
     {
         // 'AsyncStatus' is an enum
         if (isFoundationNamespace)
@@ -74,8 +74,8 @@ void metadata_cache::process_namespace_types(
         XLANG_ASSERT(added);
     }
 
-    target.structs.reserve(members.structs.size());
-    for (auto const& s : members.structs)
+    target.structs.reserve(members.structs().size());
+    for (auto const& s : members.structs())
     {
         // 'EventRegistrationToken' and 'HResult' are structs
         if (isFoundationNamespace)
@@ -93,16 +93,16 @@ void metadata_cache::process_namespace_types(
         XLANG_ASSERT(added);
     }
 
-    target.delegates.reserve(members.delegates.size());
-    for (auto const& d : members.delegates)
+    target.delegates.reserve(members.delegates().size());
+    for (auto const& d : members.delegates())
     {
         target.delegates.emplace_back(d);
         [[maybe_unused]] auto [itr, added] = table.emplace(d.TypeName(), target.delegates.back());
         XLANG_ASSERT(added);
     }
 
-    target.interfaces.reserve(members.interfaces.size());
-    for (auto const& i : members.interfaces)
+    target.interfaces.reserve(members.interfaces().size());
+    for (auto const& i : members.interfaces())
     {
         // 'IAsyncInfo' is an interface
         if (isFoundationNamespace)
@@ -120,15 +120,15 @@ void metadata_cache::process_namespace_types(
         XLANG_ASSERT(added);
     }
 
-    target.classes.reserve(members.classes.size());
-    for (auto const& c : members.classes)
+    target.classes.reserve(members.classes().size());
+    for (auto const& c : members.classes())
     {
         target.classes.emplace_back(c);
         [[maybe_unused]] auto [itr, added] = table.emplace(c.TypeName(), target.classes.back());
         XLANG_ASSERT(added);
     }
 
-    for (auto const& contract : members.contracts)
+    for (auto const& contract : members.contracts())
     {
         // Contract versions are attributes on the contract type itself
         auto attr = get_attribute(contract, metadata_namespace, "ContractVersionAttribute"sv);
@@ -24,15 +24,15 @@ namespace xlang
     static void write_version_assert(writer& w)
     {
         w.write_root_include("base");
-        auto format = R"(static_assert(xlang::check_version(CPPXLANG_VERSION, "%"), "Mismatched cppxlang headers.");
-)";
+        static constexpr text::format format{ R"(static_assert(xlang::check_version(CPPXLANG_VERSION, "%"), "Mismatched cppxlang headers.");
+)" };
         w.write(format, XLANG_VERSION_STRING);
     }
 
     static void write_include_guard(writer& w)
     {
-        auto format = R"(#pragma once
-)";
+        static constexpr text::format format{ R"(#pragma once
+)" };
 
         w.write(format);
     }
@@ -52,17 +52,17 @@ namespace xlang
             mangled_name += impl;
         }
 
-        auto format = R"(#ifndef XLANG_%_H
+        static constexpr text::format format{ R"(#ifndef XLANG_%_H
 #define XLANG_%_H
-)";
+)" };
 
         w.write(format, mangled_name, mangled_name);
     }
 
     static void write_close_file_guard(writer& w)
     {
-        auto format = R"(#endif
-)";
+        static constexpr text::format format{ R"(#endif
+)" };
 
         w.write(format);
     }
@@ -91,8 +91,8 @@ namespace xlang
 
     static void write_pch(writer& w)
     {
-        auto format = R"(#include "%"
-)";
+        static constexpr text::format format{ R"(#include "%"
+)" };
 
         if (!settings.component_pch.empty())
         {
@@ -102,9 +102,9 @@ namespace xlang
 
     static void write_impl_namespace(writer& w)
     {
-        auto format = R"(namespace xlang::impl
+        static constexpr text::format format{ R"(namespace xlang::impl
 {
-)";
+)" };
 
         w.write(format);
     }
@@ -118,25 +118,25 @@ namespace xlang
 
     static void write_type_namespace(writer& w, std::string_view const& ns)
     {
-        auto format = R"(namespace xlang::@
+        static constexpr text::format format{ R"(namespace xlang::@
 {
-)";
+)" };
 
         w.write(format, ns);
     }
 
     static void write_close_namespace(writer& w)
     {
-        auto format = R"(}
-)";
+        static constexpr text::format format{ R"(}
+)" };
 
         w.write(format);
     }
 
     static void write_enum_field(writer& w, Field const& field)
     {
-        auto format = R"(        % = %,
-)";
+        static constexpr text::format format{ R"(        % = %,
+)" };
 
         if (auto constant = field.Constant())
         {
@@ -146,10 +146,10 @@ namespace xlang
 
     static void write_enum(writer& w, TypeDef const& type)
     {
-        auto format = R"(    enum class % : %
+        static constexpr text::format format{ R"(    enum class % : %
     {
 %    };
-)";
+)" };
 
         auto fields = type.FieldList();
         w.write(format, type.TypeName(), fields.first.Signature().Type(), bind_each<write_enum_field>(fields));
@@ -188,8 +188,8 @@ namespace xlang
 
         if (get_category(type) == category::enum_type)
         {
-            auto format = R"(    enum class % : %;
-)";
+            static constexpr text::format format{ R"(    enum class % : %;
+)" };
 
             w.write(format, type_name.name, type.FieldList().first.Signature().Type());
             return;
@@ -206,15 +206,15 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    struct %;
-)";
+            static constexpr text::format format{ R"(    struct %;
+)" };
 
             w.write(format, type_name.name);
             return;
         }
 
-        auto format = R"(    template <%> struct %;
-)";
+        static constexpr text::format format{ R"(    template <%> struct %;
+)" };
 
         w.write(format,
             bind<write_generic_typenames>(generics),
@@ -228,10 +228,10 @@ namespace xlang
             return;
         }
 
-        auto format = R"(    template<> struct is_enum_flag<%> : std::true_type
+        static constexpr text::format format{ R"(    template<> struct is_enum_flag<%> : std::true_type
     {
     };
-)";
+)" };
 
         w.write(format, type);
     }
@@ -260,22 +260,22 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    template <> struct category<%>
+            static constexpr text::format format{ R"(    template <> struct category<%>
     {
         using type = %;
     };
-)";
+)" };
 
             w.write(format, type, category);
         }
         else
         {
-            auto format = R"(    template <%> struct category<%>
+            static constexpr text::format format{ R"(    template <%> struct category<%>
     {
         using type = pinterface_category<%>;
         static constexpr guid value{ % };
     };
-)";
+)" };
 
             auto attribute = get_attribute(type, "Foundation.Metadata", "GuidAttribute");
 
@@ -317,21 +317,21 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    template <> struct name<%>
+            static constexpr text::format format{ R"(    template <> struct name<%>
     {
         static constexpr auto & value{ u8"%.%" };
     };
-)";
+)" };
 
             w.write(format, type, type_name.name_space, type_name.name);
         }
         else
         {
-            auto format = R"(    template <%> struct name<%>
+            static constexpr text::format format{ R"(    template <%> struct name<%>
     {
         static constexpr auto value{ zcombine(u8"%.%<"%, u8">") };
     };
-)";
+)" };
 
             w.write(format,
                 bind<write_generic_typenames>(generics),
@@ -348,11 +348,11 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    template <> struct guid_storage<%>
+            static constexpr text::format format{ R"(    template <> struct guid_storage<%>
     {
         static constexpr guid value{ % };
     };
-)";
+)" };
 
             auto attribute = get_attribute(type, "Foundation.Metadata", "GuidAttribute");
 
@@ -367,11 +367,11 @@ namespace xlang
         }
         else
         {
-            auto format = R"(    template <%> struct guid_storage<%>
+            static constexpr text::format format{ R"(    template <%> struct guid_storage<%>
     {
         static constexpr guid value{ pinterface_guid<%>::value };
     };
-)";
+)" };
 
             w.write(format,
                 bind<write_generic_typenames>(generics),
@@ -384,22 +384,22 @@ namespace xlang
     {
         if (auto default_interface = get_default_interface(type))
         {
-            auto format = R"(    template <> struct default_interface<%>
+            static constexpr text::format format{ R"(    template <> struct default_interface<%>
 {
     using type = %;
 };
-)";
+)" };
             w.write(format, type, default_interface);
         }
     }
 
     static void write_struct_category(writer& w, TypeDef const& type)
     {
-        auto format = R"(    template <> struct category<%>
+        static constexpr text::format format{ R"(    template <> struct category<%>
     {
         using type = struct_category<%>;
     };
-)";
+)" };
 
         w.write(format, type, bind_list(", ", type.FieldList()));
     }
@@ -641,21 +641,21 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    template <> struct abi<%>
+            static constexpr text::format format{ R"(    template <> struct abi<%>
     {
         struct XLANG_NOVTABLE type : xlang_object_abi
         {
-)";
+)" };
 
             w.write(format, type);
         }
         else
         {
-            auto format = R"(    template <%> struct abi<%>
+            static constexpr text::format format{ R"(    template <%> struct abi<%>
     {
         struct XLANG_NOVTABLE type : xlang_object_abi
         {
-)";
+)" };
 
             w.write(format,
                 bind<write_generic_typenames>(generics),
@@ -663,8 +663,8 @@ namespace xlang
         }
 
 
-        auto format = R"(            virtual xlang_error_info* XLANG_CALL %(%) noexcept = 0;
-)";
+        static constexpr text::format format{ R"(            virtual xlang_error_info* XLANG_CALL %(%) noexcept = 0;
+)" };
 
         for (auto&& method : type.MethodList())
         {
@@ -679,14 +679,14 @@ namespace xlang
 
     static void write_delegate_abi(writer& w, TypeDef const& type)
     {
-        auto format = R"(    template <%> struct abi<%>
+        static constexpr text::format format{ R"(    template <%> struct abi<%>
     {
         struct XLANG_NOVTABLE type : unknown_abi
         {
             virtual xlang_error_info* XLANG_CALL Invoke(%) noexcept = 0;
         };
     };
-)";
+)" };
 
         auto generics = type.GenericParam();
         auto guard{ w.push_generic_params(generics) };
@@ -709,14 +709,14 @@ namespace xlang
     {
         w.abi_types = true;
 
-        auto format = R"(    struct struct_%
+        static constexpr text::format format{ R"(    struct struct_%
     {
 %    };
     template <> struct abi<@::%>
     {
         using type = struct_%;
     };
-)";
+)" };
 
         type_name type_name(type);
         auto impl_name = get_impl_name(type_name.name_space, type_name.name);
@@ -865,9 +865,9 @@ namespace xlang
 
         if (is_add_overload(method))
         {
-            auto format = R"(        using %_revoker = impl::event_revoker<%, &impl::abi_t<%>::remove_%>;
+            static constexpr text::format format{ R"(        using %_revoker = impl::event_revoker<%, &impl::abi_t<%>::remove_%>;
         %_revoker %(auto_revoke_t, %) const;
-)";
+)" };
 
             w.write(format,
                 method_name,
@@ -889,9 +889,9 @@ namespace xlang
 
         if (signature.return_signature().Type().is_szarray())
         {
-            auto format = R"(
+            static constexpr text::format format{ R"(
         uint32_t %_impl_size;
-        %* %;)";
+        %* %;)" };
 
             w.abi_types = true;
 
@@ -904,17 +904,17 @@ namespace xlang
         }
         else if (can_take_ownership_of_return_type(signature))
         {
-            auto format = "\n        void* %;";
+            static constexpr text::format format{ "\n        void* %;" };
             w.write(format, signature.return_param_name());
         }
         else if (std::holds_alternative<GenericTypeIndex>(signature.return_signature().Type().Type()))
         {
-            auto format = "\n        % %{ empty_value<%>() };";
+            static constexpr text::format format{ "\n        % %{ empty_value<%>() };" };
             w.write(format, signature.return_signature(), signature.return_param_name(), signature.return_signature());
         }
         else
         {
-            auto format = "\n        % %;";
+            static constexpr text::format format{ "\n        % %;" };
             w.write(format, signature.return_signature(), signature.return_param_name());
         }
     }
@@ -1199,7 +1199,7 @@ namespace xlang
 
         if (empty(generics))
         {
-            auto format = R"(    template <typename D>
+            static constexpr text::format format{ R"(    template <typename D>
     struct consume_%
     {
 %%    };
@@ -1207,7 +1207,7 @@ namespace xlang
     {
         template <typename D> using type = consume_%<D>;
     };
-)";
+)" };
 
 
             w.write(format,
@@ -1219,7 +1219,7 @@ namespace xlang
         }
         else
         {
-            auto format = R"(    template <typename D, %>
+            static constexpr text::format format{ R"(    template <typename D, %>
     struct consume_%
     {
 %%    };
@@ -1227,7 +1227,7 @@ namespace xlang
     {
         template <typename D> using type = consume_%<D, %>;
     };
-)";
+)" };
 
 
             w.write(format,
@@ -1324,8 +1324,8 @@ namespace xlang
 
         if (clear)
         {
-            auto format = R"(            clear_abi(%);
-)";
+            static constexpr text::format format{ R"(            clear_abi(%);
+)" };
 
             w.write(format, param_name);
         }
@@ -1333,8 +1333,8 @@ namespace xlang
         {
             if (signature.is_szarray())
             {
-                auto format = R"(            zero_abi<%>(%, __%Size);
-)";
+                static constexpr text::format format{ R"(            zero_abi<%>(%, __%Size);
+)" };
 
                 w.write(format,
                     signature.Type(),
@@ -1343,8 +1343,8 @@ namespace xlang
             }
             else
             {
-                auto format = R"(            zero_abi<%>(%);
-)";
+                static constexpr text::format format{ R"(            zero_abi<%>(%);
+)" };
 
                 w.write(format,
                     signature.Type(),
@@ -1353,9 +1353,9 @@ namespace xlang
         }
         else if (optional)
         {
-            auto format = R"(            if (%) *% = nullptr;
+            static constexpr text::format format{ R"(            if (%) *% = nullptr;
             Windows::Foundation::IXlangObject xlang_impl_%;
-)";
+)" };
 
             w.write(format, param_name, param_name, param_name);
         }
@@ -1567,11 +1567,11 @@ namespace xlang
 
     static void write_produce(writer& w, TypeDef const& type)
     {
-        auto format = R"(    template <typename D%>
+        static constexpr text::format format{ R"(    template <typename D%>
     struct produce<D, %> : produce_base<D, %>
     {
 %    };
-)";
+)" };
 
         auto generics = type.GenericParam();
         auto guard{ w.push_generic_params(generics) };
@@ -1585,7 +1585,7 @@ namespace xlang
 
     static void write_dispatch_overridable_method(writer& w, MethodDef const& method)
     {
-        auto format = R"(    % %(%)
+        static constexpr text::format format{ R"(    % %(%)
     {
         if (auto overridable = this->shim_overridable())
         {
@@ -1594,7 +1594,7 @@ namespace xlang
 
         return this->shim().%(%);
     }
-)";
+)" };
 
         method_signature signature{ method };
 
@@ -1610,11 +1610,11 @@ namespace xlang
 
     static void write_dispatch_overridable(writer& w, TypeDef const& class_type)
     {
-        auto format = R"(template <typename T, typename D>
+        static constexpr text::format format{ R"(template <typename T, typename D>
 struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     : produce_dispatch_to_overridable_base<T, D, %>
 {
-%};)";
+%};)" };
 
         for (auto&& [interface_name, info] : get_interfaces(w, class_type))
         {
@@ -1630,11 +1630,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static void write_interface_override_method(writer& w, MethodDef const& method, std::string_view const& interface_name)
     {
-        auto format = R"(    template <typename D> % %T<D>::%(%) const
+        static constexpr text::format format{ R"(    template <typename D> % %T<D>::%(%) const
     {
         return shim().template try_as<%>().%(%);
     }
-)";
+)" };
 
         method_signature signature{ method };
         auto method_name = get_name(method);
@@ -1662,7 +1662,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         };
     }
 
-    static void write_class_override_implements(writer& w, std::map<std::string, interface_info> const& interfaces)
+    static void write_class_override_implements(writer& w, interface_map const& interfaces)
     {
         bool found{};
 
@@ -1681,7 +1681,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         }
     }
 
-    static void write_class_override_requires(writer& w, std::map<std::string, interface_info> const& interfaces)
+    static void write_class_override_requires(writer& w, interface_map const& interfaces)
     {
         bool found{};
 
@@ -1695,7 +1695,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         }
     }
 
-    static void write_class_override_defaults(writer& w, std::map<std::string, interface_info> const& interfaces)
+    static void write_class_override_defaults(writer& w, interface_map const& interfaces)
     {
         bool first{ true };
 
@@ -1728,11 +1728,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static void write_class_override_constructors(writer& w, std::string_view const& type_name, std::map<std::string, factory_info> const& factories)
     {
-        auto format = R"(        %T(%)
+        static constexpr text::format format{ R"(        %T(%)
         {
             impl::call_factory<%, %>([&](auto&& f) { f.%(%%*this, this->m_inner); });
         }
-)";
+)" };
 
         for (auto&& [factory_name, factory] : factories)
         {
@@ -1761,7 +1761,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static void write_interface_override(writer& w, TypeDef const& type)
     {
-        auto format = R"(    template <typename D>
+        static constexpr text::format format{ R"(    template <typename D>
     class %T
     {
         D& shim() noexcept { return *static_cast<D*>(this); }
@@ -1769,7 +1769,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     public:
         using % = xlang::%;
 %    };
-)";
+)" };
 
         for (auto&& [interface_name, info] : get_interfaces(w, type))
         {
@@ -1786,9 +1786,9 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         }
     }
 
-    static void write_class_override_usings(writer& w, std::map<std::string, interface_info> const& required_interfaces)
+    static void write_class_override_usings(writer& w, interface_map const& required_interfaces)
     {
-        std::map<std::string_view, std::set<std::string>> method_usage;
+        std::map<std::string_view, std::set<std::string_view>> method_usage;
 
         for (auto&& [interface_name, info] : required_interfaces)
         {
@@ -1833,7 +1833,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
             return;
         }
 
-        auto format = R"(    template <typename D, typename... Interfaces>
+        static constexpr text::format format{ R"(    template <typename D, typename... Interfaces>
     struct %T :
         implements<D%, composing, Interfaces...>,
         impl::require<D%>,
@@ -1842,10 +1842,10 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         using composable = %;
     protected:
 %%    };
-)";
+)" };
 
         auto type_name = type.TypeName();
-        auto interfaces = get_interfaces(w, type);
+        auto const& interfaces = get_interfaces(w, type);
 
         w.write(format,
             type_name,
@@ -1861,7 +1861,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static void write_interface_requires(writer& w, TypeDef const& type)
     {
-        auto interfaces = get_interfaces(w, type);
+        auto const& interfaces = get_interfaces(w, type);
 
         if (interfaces.empty())
         {
@@ -1882,8 +1882,8 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     {
         auto type_name = type.TypeName();
         auto interfaces_plus_self = get_interfaces(w, type);
-        interfaces_plus_self[std::string{ type_name }] = interface_info{ type };
-        std::map<std::string_view, std::set<std::string>> method_usage;
+        interfaces_plus_self[type_name] = interface_info{ type };
+        std::map<std::string_view, std::set<std::string_view>> method_usage;
 
         for (auto&& [interface_name, info] : interfaces_plus_self)
         {
@@ -1915,7 +1915,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         auto type_name = type.TypeName();
         auto default_interface = get_default_interface(type);
         auto default_interface_name = w.write_temp("%", default_interface);
-        std::map<std::string_view, std::set<std::string>> method_usage;
+        std::map<std::string_view, std::set<std::string_view>> method_usage;
 
         for (auto&& [interface_name, info] : get_interfaces(w, type))
         {
@@ -1970,14 +1970,14 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
         if (empty(generics))
         {
-            auto format = R"(    struct XLANG_EBO % :
+            static constexpr text::format format{ R"(    struct XLANG_EBO % :
         Windows::Foundation::IXlangObject,
         impl::consume_t<%>%
     {
         %(std::nullptr_t = nullptr) noexcept {}
         %(void* ptr, take_ownership_from_abi_t) noexcept : Windows::Foundation::IXlangObject(ptr, take_ownership_from_abi) {}
 %%    };
-)";
+)" };
 
             w.write(format,
                 type_name,
@@ -1992,7 +1992,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         {
             type_name = remove_tick(type_name);
 
-            auto format = R"(    template <%>
+            static constexpr text::format format{ R"(    template <%>
     struct XLANG_EBO % :
         Windows::Foundation::IXlangObject,
         impl::consume_t<%>%
@@ -2000,7 +2000,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         %(std::nullptr_t = nullptr) noexcept {}
         %(void* ptr, take_ownership_from_abi_t) noexcept : Windows::Foundation::IXlangObject(ptr, take_ownership_from_abi) {}
 %%    };
-)";
+)" };
 
             w.write(format,
                 bind<write_generic_typenames>(generics),
@@ -2024,13 +2024,13 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         {
             type_name = remove_tick(type_name);
 
-            auto format = R"(    template <%>
-)";
+            static constexpr text::format format{ R"(    template <%>
+)" };
 
             w.write(format, bind<write_generic_typenames>(generics));
         }
 
-        auto format = R"(    struct % : Windows::Foundation::IUnknown
+        static constexpr text::format format{ R"(    struct % : Windows::Foundation::IUnknown
     {
         %(std::nullptr_t = nullptr) noexcept {}
         %(void* ptr, take_ownership_from_abi_t) noexcept : Windows::Foundation::IUnknown(ptr, take_ownership_from_abi) {}
@@ -2041,7 +2041,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         template <typename O, typename M> %(weak_ref<O>&& object, M method);
         % operator()(%) const;
     };
-)";
+)" };
 
         method_signature signature{ get_delegate_method(type) };
 
@@ -2060,7 +2060,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static void write_delegate_implementation(writer& w, TypeDef const& type)
     {
-        auto format = R"(    template <%> struct delegate<%>
+        static constexpr text::format format{ R"(    template <%> struct delegate<%>
     {
         template <typename H>
         struct type : implements_delegate<%, H>
@@ -2081,7 +2081,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
             }
         };
     };
-)";
+)" };
 
         w.param_names = true;
         auto generics = type.GenericParam();
@@ -2107,7 +2107,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
         if (!empty(generics))
         {
-            auto format = R"(    template <%> template <typename L> %<%>::%(L handler) :
+            static constexpr text::format format{ R"(    template <%> template <typename L> %<%>::%(L handler) :
         %(impl::make_delegate<%<%>>(std::forward<L>(handler)))
     {
     }
@@ -2131,7 +2131,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     {%
         check_xlang_error((*(impl::abi_t<%<%>>**)this)->Invoke(%));%
     }
-)";
+)" };
 
             type_name = remove_tick(type_name);
 
@@ -2176,7 +2176,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         }
         else
         {
-            auto format = R"(    template <typename L> %::%(L handler) :
+            static constexpr text::format format{ R"(    template <typename L> %::%(L handler) :
         %(impl::make_delegate<%>(std::forward<L>(handler)))
     {
     }
@@ -2200,7 +2200,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     {%
         check_xlang_error((*(impl::abi_t<%>**)this)->Invoke(%));%
     }
-)";
+)" };
 
             w.write(format,
                 type_name,
@@ -2251,7 +2251,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
     static bool write_structs(writer& w, std::vector<TypeDef> const& types)
     {
-        auto format = R"(    struct %
+        static constexpr text::format format{ R"(    struct %
     {
 %    };
     inline bool operator==(% const& left, % const& right)%
@@ -2262,7 +2262,7 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
     {
         return !(left == right);
     }
-)";
+)" };
 
         if (types.empty())
         {
@@ -2457,11 +2457,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
         method_signature signature{ method };
 
-        auto format = R"(    inline %::%(%) :
+        static constexpr text::format format{ R"(    inline %::%(%) :
         %(impl::call_factory<%, %>([&](auto&& f) { return f.%(%); }))
     {
     }
-)";
+)" };
 
         w.write(format,
             type_name,
@@ -2483,12 +2483,12 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         auto base_param = params.back().first.Name();
         params.pop_back();
 
-        auto format = R"(    inline %::%(%)
+        static constexpr text::format format{ R"(    inline %::%(%)
     {
         Windows::Foundation::IXlangObject %, %;
         *this = impl::call_factory<%, %>([&](auto&& f) { return f.%(%%%, %); });
     }
-)";
+)" };
 
         w.write(format,
             type_name,
@@ -2526,9 +2526,9 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
             if (is_add_overload(method))
             {
-                auto format = R"(        using %_revoker = impl::factory_event_revoker<%, &impl::abi_t<%>::remove_%>;
+                static constexpr text::format format{ R"(        using %_revoker = impl::factory_event_revoker<%, &impl::abi_t<%>::remove_%>;
         static %_revoker %(auto_revoke_t, %);
-)";
+)" };
 
                 w.write(format,
                     method_name,
@@ -2549,11 +2549,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         w.async_types = is_async(method, signature);
 
         {
-            auto format = R"(    inline % %::%(%)
+            static constexpr text::format format{ R"(    inline % %::%(%)
     {
         %impl::call_factory<%, %>([&](auto&& f) { return f.%(%); });
     }
-)";
+)" };
 
             w.write(format,
                 signature.return_signature(),
@@ -2569,12 +2569,12 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
 
         if (is_add_overload(method))
         {
-            auto format = R"(    inline %::%_revoker %::%(auto_revoke_t, %)
+            static constexpr text::format format{ R"(    inline %::%_revoker %::%(auto_revoke_t, %)
     {
         auto f = get_activation_factory<%, %>();
         return { f, f.%(%) };
     }
-)";
+)" };
 
             w.write(format,
                 type_name,
@@ -2604,11 +2604,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
             {
                 if (!factory.type)
                 {
-                    auto format = R"(    inline %::%() :
+                    static constexpr text::format format{ R"(    inline %::%() :
         %(impl::call_factory<%>([](auto&& f) { return f.template ActivateInstance<%>(); }))
     {
     }
-)";
+)" };
 
                     w.write(format,
                         type_name,
@@ -2638,12 +2638,12 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         auto type_name = type.TypeName();
         auto factories = get_factories(w, type);
 
-        auto format = R"(    struct XLANG_EBO % : %%%
+        static constexpr text::format format{ R"(    struct XLANG_EBO % : %%%
     {
         %(std::nullptr_t) noexcept {}
         %(void* ptr, take_ownership_from_abi_t) noexcept : %(ptr, take_ownership_from_abi) {}
 %%%    };
-)";
+)" };
 
         w.write(format,
             type_name,
@@ -2663,11 +2663,11 @@ struct XLANG_EBO produce_dispatch_to_overridable<T, D, %>
         auto type_name = type.TypeName();
         auto factories = get_factories(w, type);
 
-        auto format = R"(    struct %
+        static constexpr text::format format{ R"(    struct %
     {
         %() = delete;
 %    };
-)";
+)" };
 
         w.write(format,
             type_name,
@@ -4,7 +4,7 @@ namespace xlang
 {
     static void write_component_override_defaults(writer& w, TypeDef const& type)
     {
-        std::vector<std::string> interfaces;
+        std::vector<std::string_view> interfaces;
 
         for (auto&& base : get_bases(type))
         {
@@ -78,15 +78,15 @@ namespace xlang
 
         if (settings.component_opt)
         {
-            auto format = R"(void* xlang_make_%();
-)";
+            static constexpr text::format format{ R"(void* xlang_make_%();
+)" };
 
             w.write(format, get_impl_name(type.TypeNamespace(), type.TypeName()));
         }
         else
         {
-            auto format = R"(#include "%.h"
-)";
+            static constexpr text::format format{ R"(#include "%.h"
+)" };
 
             w.write(format, get_component_filename(type));
         }
@@ -105,12 +105,12 @@ namespace xlang
 
         if (settings.component_opt)
         {
-            auto format = R"(
+            static constexpr text::format format{ R"(
     if (requal(name, u8"%.%"))
     {
         return xlang_make_%();
     }
-)";
+)" };
 
             w.write(format,
                 type_namespace,
@@ -119,12 +119,12 @@ namespace xlang
         }
         else
         {
-            auto format = R"(
+            static constexpr text::format format{ R"(
     if (requal(name, u8"%.%"))
     {
         return xlang::detach_abi(xlang::make<xlang::@::factory_implementation::%>());
     }
-)";
+)" };
 
             w.write(format,
                 type_namespace,
@@ -137,7 +137,7 @@ namespace xlang
     static void write_module_g_cpp(writer& w, std::vector<TypeDef> const& classes)
     {
         w.write_root_include("base");
-        auto format = R"(%
+        static constexpr text::format format{ R"(%
 void* XLANG_CALL %_get_activation_factory(std::basic_string_view<xlang_char8> const& name)
 {
     auto requal = [](std::basic_string_view<xlang_char8> const& left, std::basic_string_view<xlang_char8> const& right) noexcept
@@ -147,12 +147,11 @@ void* XLANG_CALL %_get_activation_factory(std::basic_string_view<xlang_char8> co
 %
     return nullptr;
 }
-)";
+)" };
 
         w.write(format,
             bind_each<write_component_include>(classes),
             settings.component_lib,
-            settings.component_lib,
             bind_each<write_component_activation>(classes));
 
         if (settings.component_lib != "xlang")
@@ -160,7 +159,7 @@ void* XLANG_CALL %_get_activation_factory(std::basic_string_view<xlang_char8> co
             return;
         }
 
-        format = R"(
+        static constexpr text::format lib_format{ R"(
 xlang_error_info* XLANG_CALL xlang_lib_get_activation_factory(xlang_string class_name, xlang_guid const& iid, void** factory) noexcept try
 {
     uint32_t length{};
@@ -177,10 +176,9 @@ xlang_error_info* XLANG_CALL xlang_lib_get_activation_factory(xlang_string class
     return xlang::type_load_error(name).to_abi();
 }
 catch (...) { return xlang::to_xlang_error(); }
-)";
+)" };
 
-        w.write(format,
-            settings.component_lib,
+        w.write(lib_format,
             settings.component_lib);
     }
 
@@ -224,11 +222,11 @@ catch (...) { return xlang::to_xlang_error(); }
 
     static void write_component_composable_forwarder(writer& w, MethodDef const& method)
     {
-        auto format = R"(        % %(%)
+        static constexpr text::format format{ R"(        % %(%)
         {
             return impl::composable_factory<T>::template CreateInstance<%>(%);
         }
-)";
+)" };
 
         method_signature signature{ method };
         method_signature reordered_method = signature;
@@ -246,11 +244,11 @@ catch (...) { return xlang::to_xlang_error(); }
 
     static void write_component_constructor_forwarder(writer& w, MethodDef const& method)
     {
-        auto format = R"(        % %(%)
+        static constexpr text::format format{ R"(        % %(%)
         {
             return make<T>(%);
         }
-)";
+)" };
 
         method_signature signature{ method };
         w.param_names = true;
@@ -264,11 +262,11 @@ catch (...) { return xlang::to_xlang_error(); }
 
         void write_component_static_forwarder(writer& w, MethodDef const& method)
     {
-        auto format = R"(        % %(%)
+        static constexpr text::format format{ R"(        % %(%)
         {
             return T::%(%);
         }
-)";
+)" };
 
         method_signature signature{ method };
         w.param_names = true;
@@ -345,11 +343,11 @@ catch (...) { return xlang::to_xlang_error(); }
 
         if (has_factory_members(w, type))
         {
-            auto format = R"(void* xlang_make_%()
+            static constexpr text::format format{ R"(void* xlang_make_%()
 {
     return xlang::detach_abi(xlang::make<xlang::@::factory_implementation::%>());
 }
-)";
+)" };
 
             w.write(format,
                 impl_name,
@@ -370,11 +368,11 @@ catch (...) { return xlang::to_xlang_error(); }
             {
                 if (!factory.type)
                 {
-                    auto format = R"(    %::%() :
+                    static constexpr text::format format{ R"(    %::%() :
         %(make<@::implementation::%>())
     {
     }
-)";
+)" };
 
                     w.write(format,
                         type_name,
@@ -389,11 +387,11 @@ catch (...) { return xlang::to_xlang_error(); }
                     {
                         method_signature signature{ method };
 
-                        auto format = R"(    %::%(%) :
+                        static constexpr text::format format{ R"(    %::%(%) :
         %(make<@::implementation::%>(%))
     {
     }
-)";
+)" };
 
                         w.write(format,
                             type_name,
@@ -414,11 +412,11 @@ catch (...) { return xlang::to_xlang_error(); }
                     auto& params = signature.params();
                     params.resize(params.size() - 2);
 
-                    auto format = R"(    %::%(%) :
+                    static constexpr text::format format{ R"(    %::%(%) :
         %(make<@::implementation::%>(%))
     {
     }
-)";
+)" };
 
                     w.write(format,
                         type_name,
@@ -440,12 +438,12 @@ catch (...) { return xlang::to_xlang_error(); }
 
                     if (is_add_overload(method) || is_remove_overload(method))
                     {
-                        auto format = R"(    % %::%(%)
+                        static constexpr text::format format{ R"(    % %::%(%)
     {
         auto f = make<xlang::@::factory_implementation::%>().as<%>();
         return f.%(%);
     }
-)";
+)" };
 
 
                         w.write(format,
@@ -461,11 +459,11 @@ catch (...) { return xlang::to_xlang_error(); }
                     }
                     else
                     {
-                        auto format = R"(    % %::%(%)
+                        static constexpr text::format format{ R"(    % %::%(%)
     {
         return @::implementation::%::%(%);
     }
-)";
+)" };
 
 
                         w.write(format,
@@ -481,12 +479,12 @@ catch (...) { return xlang::to_xlang_error(); }
 
                     if (is_add_overload(method))
                     {
-                        auto format = R"(    %::%_revoker %::%(auto_revoke_t, %)
+                        static constexpr text::format format{ R"(    %::%_revoker %::%(auto_revoke_t, %)
     {
         auto f = make<xlang::@::factory_implementation::%>().as<%>();
         return { f, f.%(%) };
     }
-)";
+)" };
 
                         w.write(format,
                             type_name,
@@ -532,11 +530,11 @@ catch (...) { return xlang::to_xlang_error(); }
             return;
         }
 
-        auto format = R"(
+        static constexpr text::format format{ R"(
     protected:
         using dispatch = impl::dispatch_to_overridable<D@>;
         auto overridable() noexcept { return dispatch::overridable(static_cast<D&>(*this)); }
-)";
+)" };
 
         w.write(format, interfaces);
     }
@@ -570,11 +568,11 @@ catch (...) { return xlang::to_xlang_error(); }
                 auto& params = signature.params();
                 params.resize(params.size() - 2);
 
-                auto format = R"(        %_base(%)
+                static constexpr text::format format{ R"(        %_base(%)
         {
             impl::call_factory<%, %>([&](auto&& f) { f.%(%%*this, this->m_inner); });
         }
-)";
+)" };
 
                 w.write(format,
                     type_name,
@@ -592,13 +590,13 @@ catch (...) { return xlang::to_xlang_error(); }
     {
         auto type_name = type.TypeName();
         auto type_namespace = type.TypeNamespace();
-        auto interfaces = get_interfaces(w, type);
+        auto const& interfaces = get_interfaces(w, type);
         auto factories = get_factories(w, type);
         bool const non_static = !empty(type.InterfaceImpl());
 
         if (non_static)
         {
-            auto format = R"(namespace xlang::@::implementation
+            static constexpr text::format format{ R"(namespace xlang::@::implementation
 {
     template <typename D%, typename... I>
     struct XLANG_EBO %_base : implements<D, @::%%%, %I...>%%%
@@ -614,7 +612,7 @@ catch (...) { return xlang::to_xlang_error(); }
         }
 %%    };
 }
-)";
+)" };
 
             auto base_type = get_base_class(type);
             std::string composable_base_name;
@@ -630,7 +628,7 @@ catch (...) { return xlang::to_xlang_error(); }
                 if (external_base_type)
                 {
                     composable_base_name = w.write_temp("using composable_base = %;", base_type);
-                    auto base_interfaces = get_interfaces(w, base_type);
+                    auto const& base_interfaces = get_interfaces(w, base_type);
                     uint32_t base_interfaces_count{};
                     external_requires = ",\n        impl::require<D";
 
@@ -688,7 +686,7 @@ catch (...) { return xlang::to_xlang_error(); }
 
         if (has_factory_members(w, type))
         {
-            auto format = R"(namespace xlang::@::factory_implementation
+            static constexpr text::format format{ R"(namespace xlang::@::factory_implementation
 {
     template <typename D, typename T, typename... I>
     struct XLANG_EBO %T : implements<D, Windows::Foundation::IActivationFactory%, I...>
@@ -701,7 +699,7 @@ catch (...) { return xlang::to_xlang_error(); }
         }
 %    };
 }
-)";
+)" };
 
             w.write(format,
                 type_namespace,
@@ -716,7 +714,7 @@ catch (...) { return xlang::to_xlang_error(); }
 
         if (non_static)
         {
-            auto format = R"(
+            static constexpr text::format format{ R"(
 #if defined(XLANG_FORCE_INCLUDE_%_XAML_G_H) || __has_include("%.xaml.g.h")
 #include "%.xaml.g.h"
 #else
@@ -728,7 +726,7 @@ namespace xlang::@::implementation
 }
 
 #endif
-)";
+)" };
 
             std::string upper(type_name);
             std::transform(upper.begin(), upper.end(), upper.begin(), [](char c) {return static_cast<char>(::toupper(c)); });
@@ -826,7 +824,7 @@ namespace xlang::@::implementation
                 continue;
             }
 
-            w.generic_param_stack.insert(w.generic_param_stack.end(), info.generic_param_stack.begin(), info.generic_param_stack.end());
+            w.generic_param_stack.insert(w.generic_param_stack.end(), info.generic_param_stack->begin(), info.generic_param_stack->end());
 
             for (auto&& method : info.type.MethodList())
             {
@@ -841,7 +839,7 @@ namespace xlang::@::implementation
                     is_noexcept(method) ? " noexcept" : "");
             }
 
-            w.generic_param_stack.resize(w.generic_param_stack.size() - info.generic_param_stack.size());
+            w.generic_param_stack.resize(w.generic_param_stack.size() - info.generic_param_stack->size());
         }
     }
 
@@ -858,7 +856,7 @@ namespace xlang::@::implementation
         }
 
         {
-            auto format = R"(#include "%.g.h"
+            static constexpr text::format format{ R"(#include "%.g.h"
 %
 namespace xlang::@::implementation
 {
@@ -868,7 +866,7 @@ namespace xlang::@::implementation
 
 %    };
 }
-)";
+)" };
 
             w.write(format,
                 get_generated_component_filename(type),
@@ -883,13 +881,13 @@ namespace xlang::@::implementation
 
         if (has_factory_members(w, type))
         {
-            auto format = R"(namespace xlang::@::factory_implementation
+            static constexpr text::format format{ R"(namespace xlang::@::factory_implementation
 {
     struct % : %T<%, implementation::%>
     {
     };
 }
-)";
+)" };
             w.write(format,
                 type_namespace,
                 type_name,
@@ -912,11 +910,11 @@ namespace xlang::@::implementation
                     continue;
                 }
 
-                auto format = R"(    %::%(%)
+                static constexpr text::format format{ R"(    %::%(%)
     {
         throw not_implemented_error();
     }
-)";
+)" };
 
                 for (auto&& method : factory.type.MethodList())
                 {
@@ -941,11 +939,11 @@ namespace xlang::@::implementation
             }
             else if (factory.statics)
             {
-                auto format = R"(    % %::%(%)%
+                static constexpr text::format format{ R"(    % %::%(%)%
     {
         throw not_implemented_error();
     }
-)";
+)" };
 
                 for (auto&& method : factory.type.MethodList())
                 {
@@ -970,15 +968,15 @@ namespace xlang::@::implementation
                 continue;
             }
 
-            w.generic_param_stack.insert(w.generic_param_stack.end(), info.generic_param_stack.begin(), info.generic_param_stack.end());
+            w.generic_param_stack.insert(w.generic_param_stack.end(), info.generic_param_stack->begin(), info.generic_param_stack->end());
 
             for (auto&& method : info.type.MethodList())
             {
-                auto format = R"(    % %::%(%)%
+                static constexpr text::format format{ R"(    % %::%(%)%
     {
         throw not_implemented_error();
     }
-)";
+)" };
 
                 method_signature signature{ method };
                 w.async_types = is_async(method, signature);
@@ -992,7 +990,7 @@ namespace xlang::@::implementation
                     is_noexcept(method) ? " noexcept" : "");
             }
 
-            w.generic_param_stack.resize(w.generic_param_stack.size() - info.generic_param_stack.size());
+            w.generic_param_stack.resize(w.generic_param_stack.size() - info.generic_param_stack->size());
         }
     }
 
@@ -1001,25 +999,25 @@ namespace xlang::@::implementation
         auto filename = get_component_filename(type);
 
         {
-            auto format = R"(#include "%.h"
-)";
+            static constexpr text::format format{ R"(#include "%.h"
+)" };
 
             w.write(format, filename);
         }
 
         if (settings.component_opt)
         {
-            auto format = R"(#include "%.g.cpp"
-)";
+            static constexpr text::format format{ R"(#include "%.g.cpp"
+)" };
 
             w.write(format, filename);
         }
 
-        auto format = R"(
+        static constexpr text::format format{ R"(
 namespace xlang::@::implementation
 {
 %}
-)";
+)" };
 
         w.write(format,
             type.TypeNamespace(),
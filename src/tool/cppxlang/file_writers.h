@@ -2,6 +2,10 @@
 
 namespace xlang
 {
+    // Namespaces at least this large (see estimate_size) have their biggest headers streamed to
+    // disk as they are written instead of being held in memory.
+    static constexpr std::size_t stream_threshold{ 4000 };
+
     static void write_base_h()
     {
         writer w;
@@ -66,31 +70,31 @@ namespace xlang
         w.type_namespace = ns;
 
         write_type_namespace(w, ns);
-        w.write_each<write_enum>(members.enums);
-        w.write_each<write_forward>(members.interfaces);
-        w.write_each<write_forward>(members.classes);
-        w.write_each<write_forward>(members.structs);
-        w.write_each<write_forward>(members.delegates);
+        w.write_each<write_enum>(members.enums());
+        w.write_each<write_forward>(members.interfaces());
+        w.write_each<write_forward>(members.classes());
+        w.write_each<write_forward>(members.structs());
+        w.write_each<write_forward>(members.delegates());
         write_close_namespace(w);
         write_impl_namespace(w);
-        w.write_each<write_enum_flag>(members.enums);
-        w.write_each<write_category>(members.interfaces, "interface_category");
-        w.write_each<write_category>(members.classes, "class_category");
-        w.write_each<write_category>(members.enums, "enum_category");
-        w.write_each<write_struct_category>(members.structs);
-        w.write_each<write_category>(members.delegates, "delegate_category");
-        w.write_each<write_name>(members.interfaces);
-        w.write_each<write_name>(members.classes);
-        w.write_each<write_name>(members.enums);
-        w.write_each<write_name>(members.structs);
-        w.write_each<write_name>(members.delegates);
-        w.write_each<write_guid>(members.interfaces);
-        w.write_each<write_guid>(members.delegates);
-        w.write_each<write_default_interface>(members.classes);
-        w.write_each<write_interface_abi>(members.interfaces);
-        w.write_each<write_delegate_abi>(members.delegates);
-        w.write_each<write_consume>(members.interfaces);
-        w.write_each<write_struct_abi>(members.structs);
+        w.write_each<write_enum_flag>(members.enums());
+        w.write_each<write_category>(members.interfaces(), "interface_category");
+        w.write_each<write_category>(members.classes(), "class_category");
+        w.write_each<write_category>(members.enums(), "enum_category");
+        w.write_each<write_struct_category>(members.structs());
+        w.write_each<write_category>(members.delegates(), "delegate_category");
+        w.write_each<write_name>(members.interfaces());
+        w.write_each<write_name>(members.classes());
+        w.write_each<write_name>(members.enums());
+        w.write_each<write_name>(members.structs());
+        w.write_each<write_name>(members.delegates());
+        w.write_each<write_guid>(members.interfaces());
+        w.write_each<write_guid>(members.delegates());
+        w.write_each<write_default_interface>(members.classes());
+        w.write_each<write_interface_abi>(members.interfaces());
+        w.write_each<write_delegate_abi>(members.delegates());
+        w.write_each<write_consume>(members.interfaces());
+        w.write_each<write_struct_abi>(members.structs());
         write_close_namespace(w);
 
         write_close_file_guard(w);
@@ -114,7 +118,7 @@ namespace xlang
         w.type_namespace = ns;
 
         write_type_namespace(w, ns);
-        w.write_each<write_interface>(members.interfaces);
+        w.write_each<write_interface>(members.interfaces());
         write_close_namespace(w);
 
         write_close_file_guard(w);
@@ -136,11 +140,16 @@ namespace xlang
         writer w;
         w.type_namespace = ns;
 
+        if (estimate_size(members) >= stream_threshold)
+        {
+            w.stream_header('2');
+        }
+
         write_type_namespace(w, ns);
-        w.write_each<write_delegate>(members.delegates);
-        bool const promote = write_structs(w, members.structs);
-        w.write_each<write_class>(members.classes);
-        w.write_each<write_interface_override>(members.classes);
+        w.write_each<write_delegate>(members.delegates());
+        bool const promote = write_structs(w, members.structs());
+        w.write_each<write_class>(members.classes());
+        w.write_each<write_interface_override>(members.classes());
         write_close_namespace(w);
         write_namespace_special(w, ns, c);
 
@@ -165,22 +174,27 @@ namespace xlang
         writer w;
         w.type_namespace = ns;
 
+        if (estimate_size(members) >= stream_threshold)
+        {
+            w.stream_header();
+        }
+
         write_impl_namespace(w);
-        w.write_each<write_consume_definitions>(members.interfaces);
-        w.write_each<write_delegate_implementation>(members.delegates);
-        w.write_each<write_produce>(members.interfaces);
-        w.write_each<write_dispatch_overridable>(members.classes);
+        w.write_each<write_consume_definitions>(members.interfaces());
+        w.write_each<write_delegate_implementation>(members.delegates());
+        w.write_each<write_produce>(members.interfaces());
+        w.write_each<write_dispatch_overridable>(members.classes());
         write_close_namespace(w);
         write_type_namespace(w, ns);
-        w.write_each<write_class_definitions>(members.classes);
+        w.write_each<write_class_definitions>(members.classes());
 
-        w.write_each<write_delegate_definition>(members.delegates);
-        w.write_each<write_interface_override_methods>(members.classes);
-        w.write_each<write_class_override>(members.classes);
+        w.write_each<write_delegate_definition>(members.delegates());
+        w.write_each<write_interface_override_methods>(members.classes());
+        w.write_each<write_class_override>(members.classes());
         write_close_namespace(w);
         write_std_namespace(w);
-        w.write_each<write_std_hash>(members.interfaces);
-        w.write_each<write_std_hash>(members.classes);
+        w.write_each<write_std_hash>(members.interfaces());
+        w.write_each<write_std_hash>(members.classes());
         write_close_namespace(w);
 
         write_close_file_guard(w);
@@ -217,6 +217,54 @@ namespace xlang
         return bases;
     }
 
+    using generic_params = std::vector<std::vector<std::string>>;
+
+    // Keeps a single copy of each value for the lifetime of the process so that cached results can
+    // refer to values by address. Lookups take a shared lock and only new values take an exclusive one.
+    template <typename T>
+    struct interner
+    {
+        template <typename Value>
+        T const& get(Value&& value)
+        {
+            {
+                std::shared_lock guard{ m_lock };
+                auto found = m_values.find(value);
+
+                if (found != m_values.end())
+                {
+                    return *found;
+                }
+            }
+
+            std::unique_lock guard{ m_lock };
+            return *m_values.emplace(std::forward<Value>(value)).first;
+        }
+
+    private:
+
+        std::shared_mutex m_lock;
+        std::set<T, std::less<>> m_values;
+    };
+
+    static std::string_view intern_name(std::string&& name)
+    {
+        static interner<std::string> names;
+        return names.get(std::move(name));
+    }
+
+    static generic_params const* intern_generic_params(generic_params const& params)
+    {
+        static interner<generic_params> stacks;
+        return &stacks.get(params);
+    }
+
+    static generic_params const* empty_generic_params()
+    {
+        static auto const empty = intern_generic_params({});
+        return empty;
+    }
+
     struct interface_info
     {
         TypeDef type;
@@ -224,16 +272,18 @@ namespace xlang
         bool defaulted{};
         bool overridable{};
         bool base{};
-        std::vector<std::vector<std::string>> generic_param_stack{};
+        generic_params const* generic_param_stack{ empty_generic_params() };
     };
 
-    static void get_interfaces_impl(writer& w, std::map<std::string, interface_info>& result, bool defaulted, bool overridable, bool base, std::vector<std::vector<std::string>> const& generic_param_stack, std::pair<InterfaceImpl, InterfaceImpl>&& children)
+    using interface_map = std::map<std::string_view, interface_info>;
+
+    static void get_interfaces_impl(writer& w, interface_map& result, bool defaulted, bool overridable, bool base, generic_params const* generic_param_stack, std::pair<InterfaceImpl, InterfaceImpl>&& children)
     {
         for (auto&& impl : children)
         {
             interface_info info;
             auto type = impl.Interface();
-            auto name = w.write_temp("%", type);
+            auto name = intern_name(w.write_temp("%", type));
             info.is_default = has_attribute(impl, "Windows.Foundation.Metadata", "DefaultAttribute");
             info.defaulted = !base && (defaulted || info.is_default);
 
@@ -285,7 +335,9 @@ namespace xlang
                     names.push_back(w.write_temp("%", arg));
                 }
 
-                info.generic_param_stack.push_back(std::move(names));
+                auto stack = *generic_param_stack;
+                stack.push_back(std::move(names));
+                info.generic_param_stack = intern_generic_params(stack);
 
                 guard = w.push_generic_params(type_signature.GenericTypeInst());
                 auto signature = type_signature.GenericTypeInst();
@@ -300,17 +352,67 @@ namespace xlang
         }
     };
 
-    static auto get_interfaces(writer& w, TypeDef const& type)
+    // Several writers ask for the interfaces of the same class, so they are resolved once for each
+    // class and each combination of writer state that affects the interface names. The result is
+    // shared by every thread and the dependencies found along the way are replayed on each writer.
+    // Interface names and generic argument stacks are interned, so neither the key nor the result
+    // copies them.
+    static interface_map const& get_interfaces(writer& w, TypeDef const& type)
     {
-        std::map<std::string, interface_info> result;
-        get_interfaces_impl(w, result, false, false, false, {}, type.InterfaceImpl());
+        struct interfaces
+        {
+            interface_map result;
+            std::vector<TypeDef> depends;
+        };
+
+        using key = std::tuple<TypeDef, bool, bool, bool, generic_params const*>;
+        static std::shared_mutex lock;
+        static std::map<key, std::unique_ptr<interfaces const>> cache;
+
+        key const id{ type, w.abi_types, w.consume_types, w.async_types, intern_generic_params(w.generic_param_stack) };
+        interfaces const* found{};
 
-        for (auto&& base : get_bases(type))
         {
-            get_interfaces_impl(w, result, false, false, true, {}, base.InterfaceImpl());
+            std::shared_lock guard{ lock };
+            auto existing = cache.find(id);
+
+            if (existing != cache.end())
+            {
+                found = existing->second.get();
+            }
         }
 
-        return result;
+        if (!found)
+        {
+            writer scratch;
+            scratch.abi_types = w.abi_types;
+            scratch.consume_types = w.consume_types;
+            scratch.async_types = w.async_types;
+            scratch.generic_param_stack = w.generic_param_stack;
+
+            auto value = std::make_unique<interfaces>();
+            get_interfaces_impl(scratch, value->result, false, false, false, empty_generic_params(), type.InterfaceImpl());
+
+            for (auto&& base : get_bases(type))
+            {
+                get_interfaces_impl(scratch, value->result, false, false, true, empty_generic_params(), base.InterfaceImpl());
+            }
+
+            for (auto&& [ns, types] : scratch.depends)
+            {
+                value->depends.insert(value->depends.end(), types.begin(), types.end());
+            }
+
+            std::unique_lock guard{ lock };
+            found = cache.try_emplace(id, std::move(value)).first->second.get();
+        }
+
+        for (auto&& depends : found->depends)
+        {
+            w.add_depends(depends);
+        }
+
+        return found->result;
     }
 
     struct factory_info
@@ -542,10 +644,128 @@ namespace xlang
     static bool has_projected_types(cache::namespace_members const& members)
     {
         return
-            !members.interfaces.empty() ||
-            !members.classes.empty() ||
-            !members.enums.empty() ||
-            !members.structs.empty() ||
-            !members.delegates.empty();
+            !members.interfaces().empty() ||
+            !members.classes().empty() ||
+            !members.enums().empty() ||
+            !members.structs().empty() ||
+            !members.delegates().empty();
     }
+
+    // Identifies the metadata that a namespace's headers are generated from: the files defining the
+    // namespace or any of its parents, along with every file those refer to directly or indirectly
+    // through their type references. Files are identified by path, size and last write time, and a
+    // namespace depending on a file that can't be identified has no digest.
+    struct namespace_inputs
+    {
+        explicit namespace_inputs(cache const& c)
+        {
+            std::size_t index{};
+
+            for (auto&& db : c.databases())
+            {
+                std::error_code size_error;
+                std::error_code time_error;
+                auto const size = std::filesystem::file_size(db.path(), size_error);
+                auto const time = std::filesystem::last_write_time(db.path(), time_error);
+
+                if (db.path().empty() || size_error || time_error)
+                {
+                    m_files.emplace_back();
+                }
+                else
+                {
+                    m_files.push_back(db.path() + '\n' + std::to_string(size) + '\n' + std::to_string(time.time_since_epoch().count()));
+                }
+
+                for (auto&& type : db.TypeDef)
+                {
+                    m_definitions[type.TypeNamespace()].insert(index);
+                }
+
+                ++index;
+            }
+
+            m_references.resize(m_files.size());
+            index = 0;
+
+            for (auto&& db : c.databases())
+            {
+                std::set<std::string_view> namespaces;
+
+                for (auto&& type : db.TypeRef)
+                {
+                    namespaces.insert(type.TypeNamespace());
+                }
+
+                for (auto&& ns : namespaces)
+                {
+                    auto found = m_definitions.find(ns);
+
+                    if (found != m_definitions.end())
+                    {
+                        m_references[index].insert(found->second.begin(), found->second.end());
+                    }
+                }
+
+                ++index;
+            }
+        }
+
+        // Combines the identity of the namespace's input files with options that also affect the
+        // generated headers.
+        std::optional<uint64_t> digest(std::string_view const& ns, std::string_view const& options) const
+        {
+            std::set<std::size_t> files;
+            std::vector<std::size_t> pending;
+
+            for (auto name = ns;; name = name.substr(0, name.rfind('.')))
+            {
+                auto found = m_definitions.find(name);
+
+                if (found != m_definitions.end())
+                {
+                    pending.insert(pending.end(), found->second.begin(), found->second.end());
+                }
+
+                if (name.find('.') == std::string_view::npos)
+                {
+                    break;
+                }
+            }
+
+            while (!pending.empty())
+            {
+                auto const file = pending.back();
+                pending.pop_back();
+
+                if (files.insert(file).second)
+                {
+                    pending.insert(pending.end(), m_references[file].begin(), m_references[file].end());
+                }
+            }
+
+            impl::content_hash hash;
+            hash.update(options.data(), options.size());
+            hash.update(ns.data(), ns.size());
+
+            for (auto&& file : files)
+            {
+                if (m_files[file].empty())
+                {
+                    return {};
+                }
+
+                hash.update("\n", 1);
+                hash.update(m_files[file].data(), m_files[file].size());
+            }
+
+            return hash.value();
+        }
+
+    private:
+
+        std::vector<std::string> m_files;
+        std::map<std::string_view, std::set<std::size_t>> m_definitions;
+        std::vector<std::set<std::size_t>> m_references;
+    };
 }
@@ -2,6 +2,7 @@
 #include <time.h>
 #include "strings.h"
 #include "settings.h"
+#include "profile.h"
 #include "type_writers.h"
 #include "helpers.h"
 #include "code_writers.h"
@@ -32,6 +33,11 @@ namespace xlang
         { "optimize", 0, 0, {}, "Generate component projection with unified construction support" },
         { "help", 0, cmd::option::no_max, {}, "Show detailed help with examples" },
         { "library", 0, 1, "<prefix>", "Specify library prefix (defaults to winrt)" },
+        { "snapshot", 0, 1, "<path>", "Cache indexed metadata in a snapshot file to speed up later runs" },
+        { "jobs", 0, 1, "<count>", "Limit concurrent tasks (defaults to make jobserver or processor count)" },
+        { "manifest", 0, 1, "<path>", "Record generated file hashes to skip comparing unchanged files" },
+        { "incremental", 0, 0, {}, "Skip namespaces whose input metadata is unchanged since the last run" },
+        { "profile", 0, 1, "<path>", "Write a Chrome trace of header generation with the include graph" },
         { "filter" }, // One or more prefixes to include in input (same as -include)
         { "license", 0, 0 }, // Generate license comment
         { "brackets", 0, 0 }, // Use angle brackets for #includes (defaults to quotes)
@@ -53,7 +59,7 @@ namespace xlang
             printColumns(w, w.write_temp("-% %", opt.name, opt.arg), opt.desc);
         };
 
-        auto format = R"(
+        static constexpr text::format format{ R"(
 cppxlang v%
 Copyright (c) Microsoft Corporation. All rights reserved.
 
@@ -69,7 +75,7 @@ Where <spec> is one or more of:
   local               Local ^%WinDir^%\System32\WinMetadata folder
   sdk[+]              Current version of Windows SDK [with extensions]
   10.0.12345.0[+]     Specific version of Windows SDK [with extensions]
-)";
+)" };
         w.write(format, XLANG_VERSION_STRING, bind_each(printOption, options));
     }
 
@@ -83,6 +89,11 @@ Where <spec> is one or more of:
         }
 
         settings.verbose = args.exists("verbose");
+        settings.snapshot = args.value("snapshot");
+        settings.manifest = args.value("manifest");
+        settings.incremental = args.exists("incremental");
+        settings.profile = args.value("profile");
+        task_group::configure(get_task_group_options(args.value("jobs")));
 
         settings.input = args.files("input", database::is_database);
         settings.reference = args.files("reference", database::is_database);
@@ -161,6 +172,20 @@ Where <spec> is one or more of:
         return files;
     }
 
+    static auto get_cache_options()
+    {
+        cache_options options;
+        options.parallel = true;
+
+        // Namespaces excluded by the filters, such as those of reference winmds, are never categorized.
+        options.deferred = true;
+
+        // The 0/1/2/full header writers each decode the signatures of the same members.
+        options.signatures = true;
+        options.snapshot = settings.snapshot;
+        return options;
+    }
+
     static void build_filters(cache const& c)
     {
         if (settings.reference.empty())
@@ -204,6 +229,112 @@ Where <spec> is one or more of:
 
     }
 
+    // The digest of each namespace's inputs as of the last incremental run is kept in the output
+    // folder, one namespace per line. It is removed when a run starts and only written again once
+    // every header has been generated, so a run that fails part way leaves nothing to skip.
+    static auto get_incremental_path()
+    {
+        return settings.output_folder + "xlang/.incremental";
+    }
+
+    static auto load_incremental_digests()
+    {
+        std::map<std::string, uint64_t> digests;
+        std::ifstream file{ get_incremental_path() };
+        std::string line;
+
+        while (std::getline(file, line))
+        {
+            auto const separator = line.find(' ');
+
+            if (separator != std::string::npos)
+            {
+                digests[line.substr(separator + 1)] = std::strtoull(line.c_str(), nullptr, 16);
+            }
+        }
+
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(get_incremental_path(), ec);
+
+        if (ec)
+        {
+            throw_invalid("Could not remove file '", get_incremental_path(), "'");
+        }
+
+        return digests;
+    }
+
+    static void save_incremental_digests(std::map<std::string_view, uint64_t> const& digests)
+    {
+        auto const path = get_incremental_path();
+        auto const temp = path + ".tmp";
+
+        {
+            std::ofstream file{ temp, std::ios::out | std::ios::trunc };
+
+            for (auto&& [ns, digest] : digests)
+            {
+                char value[17];
+                snprintf(value, sizeof(value), "%016" PRIx64, digest);
+                file << value << ' ' << ns << '\n';
+            }
+
+            if (!file.flush())
+            {
+                throw_invalid("Could not write file '", temp, "'");
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+
+        if (ec)
+        {
+            throw_invalid("Could not rename file '", temp, "' to '", path, "'");
+        }
+    }
+
+    // Everything other than the metadata that affects the generated namespace headers.
+    static auto get_incremental_options()
+    {
+        std::string options{ XLANG_VERSION_STRING };
+
+        auto add = [&](std::string_view const& value)
+        {
+            options += '\n';
+            options += value;
+        };
+
+        add(settings.component ? "component" : "");
+        add(settings.component_opt ? "optimize" : "");
+        add(settings.license ? "license" : "");
+        add(settings.brackets ? "brackets" : "");
+
+        for (auto&& values : { &settings.input, &settings.reference, &settings.include, &settings.exclude })
+        {
+            add("");
+
+            for (auto&& value : *values)
+            {
+                add(value);
+            }
+        }
+
+        return options;
+    }
+
+    static bool has_namespace_headers(std::string_view const& ns)
+    {
+        auto const folder = settings.output_folder + "xlang/";
+        auto const name = std::string{ ns };
+
+        return exists(folder + name + ".h") &&
+            exists(folder + "impl/" + name + ".0.h") &&
+            exists(folder + "impl/" + name + ".1.h") &&
+            exists(folder + "impl/" + name + ".2.h");
+    }
+
     static void remove_foundation_types(cache& c)
     {
         c.remove_type("Foundation", "DateTime");
@@ -220,7 +351,7 @@ Where <spec> is one or more of:
         {
             auto start = get_start_time();
             process_args(argc, argv);
-            cache c{ get_files_to_cache() };
+            cache c{ get_files_to_cache(), get_cache_options() };
             remove_foundation_types(c);
             build_filters(c);
             settings.base = settings.base || (!settings.component && settings.projection_filter.empty());
@@ -249,66 +380,146 @@ Where <spec> is one or more of:
             }
 
             w.flush_to_console();
-            task_group group;
+            std::optional<output_manifest> manifest;
 
-            for (auto&&[ns, members] : c.namespaces())
+            if (!settings.manifest.empty())
             {
-                group.add([&, &ns = ns, &members = members]
+                output_manifest::current() = &manifest.emplace(settings.manifest);
+            }
+
+            std::map<std::string, uint64_t> previous_digests;
+            std::map<std::string_view, uint64_t> digests;
+
+            if (settings.incremental)
+            {
+                previous_digests = load_incremental_digests();
+                namespace_inputs inputs{ c };
+                auto const options = get_incremental_options();
+
+                for (auto&&[ns, members] : c.namespaces())
                 {
-                    if (!has_projected_types(members) || !settings.projection_filter.includes(members))
+                    if (auto const digest = inputs.digest(ns, options))
                     {
-                        return;
+                        digests[ns] = *digest;
                     }
+                }
+            }
 
-                    write_namespace_0_h(ns, members);
-                    write_namespace_1_h(ns, members);
-                    write_namespace_2_h(ns, members, c);
-                    write_namespace_h(c, ns, members);
-                });
+            std::optional<profile> profiler;
+
+            if (!settings.profile.empty())
+            {
+                profile::current() = &profiler.emplace();
             }
 
-            group.add([&]
+            // The component classes are gathered up front so that module.g.cpp always lists them in
+            // the same order while the files for each class are written in parallel.
+            std::vector<TypeDef> classes;
+
+            if (settings.component)
             {
-                if (settings.base)
+                for (auto&&[ns, members] : c.namespaces())
                 {
-                    write_base_h();
-                    write_coroutine_h();
+                    for (auto&& type : members.classes())
+                    {
+                        if (settings.component_filter.includes(type))
+                        {
+                            classes.push_back(type);
+                        }
+                    }
                 }
+            }
 
-                if (settings.component)
-                {
-                    std::vector<TypeDef> classes;
+            task_group group;
+            std::atomic<uint32_t> skipped{};
+
+            // Namespaces are queued largest first so that the biggest ones are not left on the
+            // critical path.
+            for (auto&& entry : get_namespaces_by_size(c))
+            {
+                auto&&[ns, members] = *entry;
 
-                    for (auto&&[ns, members] : c.namespaces())
+                group.add([&, &ns = ns, &members = members]
+                {
+                    if (!has_projected_types(members) || !settings.projection_filter.includes(members))
                     {
-                        for (auto&& type : members.classes)
-                        {
-                            if (settings.component_filter.includes(type))
-                            {
-                                classes.push_back(type);
-                            }
-                        }
+                        return;
                     }
 
-                    if (!classes.empty())
+                    if (settings.incremental)
                     {
-                        write_module_g_cpp(classes);
+                        auto previous = previous_digests.find(std::string{ ns });
+                        auto current = digests.find(ns);
 
-                        for (auto&& type : classes)
+                        if (previous != previous_digests.end() && current != digests.end() && previous->second == current->second && has_namespace_headers(ns))
                         {
-                            write_component_g_h(type);
-                            write_component_g_cpp(type);
-                            write_component_h(type);
-                            write_component_cpp(type);
+                            ++skipped;
+                            return;
                         }
                     }
+
+                    auto const types = members.types.size();
+                    profile::measure(ns, '0', types, [&] { write_namespace_0_h(ns, members); });
+                    profile::measure(ns, '1', types, [&] { write_namespace_1_h(ns, members); });
+                    profile::measure(ns, '2', types, [&] { write_namespace_2_h(ns, members, c); });
+                    profile::measure(ns, 0, types, [&] { write_namespace_h(c, ns, members); });
+                });
+            }
+
+            if (settings.base)
+            {
+                group.add([]
+                {
+                    write_base_h();
+                    write_coroutine_h();
+                });
+            }
+
+            if (!classes.empty())
+            {
+                group.add([&]
+                {
+                    write_module_g_cpp(classes);
+                });
+
+                for (auto&& type : classes)
+                {
+                    group.add([&type]
+                    {
+                        write_component_g_h(type);
+                        write_component_g_cpp(type);
+                        write_component_h(type);
+                        write_component_cpp(type);
+                    });
                 }
-            });
+            }
 
             group.get();
 
+            if (settings.incremental)
+            {
+                save_incremental_digests(digests);
+            }
+
+            if (profiler)
+            {
+                profiler->save(settings.profile);
+                profile::current() = nullptr;
+            }
+
+            if (manifest)
+            {
+                manifest->save();
+                output_manifest::current() = nullptr;
+            }
+
             if (settings.verbose)
             {
+                if (settings.incremental)
+                {
+                    w.write(" skip:  % unchanged namespaces\n", skipped.load());
+                }
+
                 w.write(" time:  %ms\n", get_elapsed_time(start));
             }
         }
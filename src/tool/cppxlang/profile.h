@@ -0,0 +1,138 @@
+#pragma once
+
+namespace xlang
+{
+    // Collects the time spent writing each namespace header along with its size, type count and
+    // the headers it includes. The result is saved in the Chrome trace event format, which can be
+    // viewed with chrome://tracing or Perfetto, with the include graph stored alongside the events.
+    struct profile
+    {
+        profile(profile const&) = delete;
+        profile& operator=(profile const&) = delete;
+
+        profile() = default;
+
+        static profile*& current() noexcept
+        {
+            static profile* value{};
+            return value;
+        }
+
+        // Runs write, recording how long it took if profiling is enabled.
+        template <typename F>
+        static void measure(std::string_view const& ns, char const impl, std::size_t const types, F&& write)
+        {
+            auto self = current();
+
+            if (!self)
+            {
+                write();
+                return;
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            write();
+            auto const finish = std::chrono::steady_clock::now();
+
+            std::lock_guard guard{ self->m_lock };
+            auto& value = self->m_headers[get_header_name(ns, impl)];
+            value.ns = ns;
+            value.start = microseconds(start - self->m_start);
+            value.duration = microseconds(finish - start);
+            value.thread = self->get_thread();
+            value.types = types;
+        }
+
+        void add_header(std::string_view const& ns, char const impl, uint64_t const bytes, std::vector<std::string> const& includes)
+        {
+            std::lock_guard guard{ m_lock };
+            auto& value = m_headers[get_header_name(ns, impl)];
+            value.bytes = bytes;
+            value.includes = includes;
+        }
+
+        void save(std::string const& filename) const
+        {
+            std::lock_guard guard{ m_lock };
+            std::ofstream file{ filename, std::ios::out | std::ios::trunc };
+            file << "{\n\"traceEvents\": [";
+            char const* separator = "\n";
+
+            for (auto&& [name, value] : m_headers)
+            {
+                file << separator << "{ \"name\": \"" << name << "\", \"cat\": \"namespace\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << value.thread
+                    << ", \"ts\": " << value.start << ", \"dur\": " << value.duration
+                    << ", \"args\": { \"namespace\": \"" << value.ns << "\", \"types\": " << value.types << ", \"bytes\": " << value.bytes << " } }";
+
+                separator = ",\n";
+            }
+
+            file << "\n],\n\"displayTimeUnit\": \"ms\",\n\"includes\": {";
+            separator = "\n";
+
+            for (auto&& [name, value] : m_headers)
+            {
+                file << separator << "\"" << name << "\": [";
+                char const* item_separator = "";
+
+                for (auto&& include : value.includes)
+                {
+                    file << item_separator << "\"" << include << ".h\"";
+                    item_separator = ", ";
+                }
+
+                file << "]";
+                separator = ",\n";
+            }
+
+            file << "\n}\n}\n";
+
+            if (!file.flush())
+            {
+                throw_invalid("Could not write file '", filename, "'");
+            }
+        }
+
+    private:
+
+        struct header
+        {
+            std::string ns;
+            int64_t start{};
+            int64_t duration{};
+            uint32_t thread{};
+            std::size_t types{};
+            uint64_t bytes{};
+            std::vector<std::string> includes;
+        };
+
+        static std::string get_header_name(std::string_view const& ns, char const impl)
+        {
+            std::string name{ impl ? "impl/" : "" };
+            name += ns;
+
+            if (impl)
+            {
+                name += '.';
+                name += impl;
+            }
+
+            return name + ".h";
+        }
+
+        static int64_t microseconds(std::chrono::steady_clock::duration const& value) noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(value).count();
+        }
+
+        uint32_t get_thread()
+        {
+            return m_threads.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(m_threads.size() + 1)).first->second;
+        }
+
+        std::chrono::steady_clock::time_point const m_start{ std::chrono::steady_clock::now() };
+        mutable std::mutex m_lock;
+        std::map<std::string, header> m_headers;
+        std::map<std::thread::id, uint32_t> m_threads;
+    };
+}
@@ -22,6 +22,10 @@ namespace xlang
         bool component_opt{};
 
         bool verbose{};
+        std::string snapshot;
+        std::string manifest;
+        bool incremental{};
+        std::string profile;
 
         std::set<std::string> include;
         std::set<std::string> exclude;
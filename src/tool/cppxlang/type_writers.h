@@ -78,6 +78,7 @@ namespace xlang
         bool async_types{};
         std::map<std::string_view, std::set<TypeDef>> depends;
         std::vector<std::vector<std::string>> generic_param_stack;
+        std::vector<std::string> includes;
 
         struct generic_param_guard
         {
@@ -444,13 +445,18 @@ namespace xlang
 
         void write_root_include(std::string_view const& include)
         {
-            auto format = R"(#include %xlang/%.h%
-)";
+            static constexpr text::format format{ R"(#include %xlang/%.h%
+)" };
 
             write(format,
                 settings.brackets ? '<' : '\"',
                 include,
                 settings.brackets ? '>' : '\"');
+
+            if (profile::current())
+            {
+                includes.emplace_back(include);
+            }
         }
 
         void write_depends(std::string_view const& ns, char impl = 0)
@@ -465,7 +471,7 @@ namespace xlang
             }
         }
 
-        void save_header(char impl = 0)
+        std::string header_filename(char impl = 0) const
         {
             auto filename{ settings.output_folder + "xlang/" };
 
@@ -483,7 +489,24 @@ namespace xlang
             }
 
             filename += ".h";
+            return filename;
+        }
+
+        // Writes the header body to disk as it is generated rather than holding it in memory.
+        void stream_header(char impl = 0)
+        {
+            stream_to_file(header_filename(impl));
+        }
+
+        void save_header(char impl = 0)
+        {
+            auto const filename = header_filename(impl);
             flush_to_file(filename);
+
+            if (auto profiler = profile::current())
+            {
+                profiler->add_header(type_namespace, impl, file_size(filename), includes);
+            }
         }
     };
 }
@@ -254,9 +254,9 @@ struct winrt_type<%>
             write_try_catch(w, [&](auto& w)
                 {
                     w.write("py::pyobj_handle bases { PyTuple_Pack(1, py::winrt_type<py::winrt_base>::python_type) };\n\n");
-                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.classes)(w);
-                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.interfaces)(w);
-                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.structs)(w);
+                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.classes())(w);
+                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.interfaces())(w);
+                    settings.filter.bind_each<write_ns_module_exec_init_python_type>(members.structs())(w);
                     w.write("\nreturn 0;\n");
                 }, "-1");
         }
@@ -45,36 +45,36 @@ namespace pywinrt
         w.write("\nnamespace py::proj::%\n{", bind_list("::", segments));
         {
             writer::indent_guard g{ w };
-            settings.filter.bind_each<write_pinterface_decl>(members.interfaces)(w);
+            settings.filter.bind_each<write_pinterface_decl>(members.interfaces())(w);
         }
         w.write("}\n");
 
         w.write("\nnamespace py::impl::%\n{", bind_list("::", segments));
         {
             writer::indent_guard g{ w };
-            settings.filter.bind_each<write_delegate_callable_wrapper>(members.delegates)(w);
-            settings.filter.bind_each<write_pinterface_impl>(members.interfaces)(w);
+            settings.filter.bind_each<write_delegate_callable_wrapper>(members.delegates())(w);
+            settings.filter.bind_each<write_pinterface_impl>(members.interfaces())(w);
         }
         w.write("}\n");
 
         w.write("\nnamespace py::wrapper::%\n{\n", bind_list("::", segments));
         {
             writer::indent_guard g{ w };
-            settings.filter.bind_each<write_python_wrapper_alias>(members.classes)(w);
-            settings.filter.bind_each<write_python_wrapper_alias>(members.interfaces)(w);
-            settings.filter.bind_each<write_python_wrapper_alias>(members.structs)(w);
+            settings.filter.bind_each<write_python_wrapper_alias>(members.classes())(w);
+            settings.filter.bind_each<write_python_wrapper_alias>(members.interfaces())(w);
+            settings.filter.bind_each<write_python_wrapper_alias>(members.structs())(w);
         }
         w.write("}\n");
 
         w.write("\nnamespace py\n{\n");
         {
             writer::indent_guard g{ w };
-            settings.filter.bind_each<write_get_python_type_specialization>(members.classes)(w);
-            settings.filter.bind_each<write_get_python_type_specialization>(members.interfaces)(w);
-            settings.filter.bind_each<write_get_python_type_specialization>(members.structs)(w);
-            settings.filter.bind_each<write_pinterface_type_mapper>(members.interfaces)(w);
-            settings.filter.bind_each<write_delegate_type_mapper>(members.delegates)(w);
-            settings.filter.bind_each<write_struct_converter_decl>(members.structs)(w);
+            settings.filter.bind_each<write_get_python_type_specialization>(members.classes())(w);
+            settings.filter.bind_each<write_get_python_type_specialization>(members.interfaces())(w);
+            settings.filter.bind_each<write_get_python_type_specialization>(members.structs())(w);
+            settings.filter.bind_each<write_pinterface_type_mapper>(members.interfaces())(w);
+            settings.filter.bind_each<write_delegate_type_mapper>(members.delegates())(w);
+            settings.filter.bind_each<write_struct_converter_decl>(members.structs())(w);
         }
         w.write("}\n");
 
@@ -111,24 +111,24 @@ namespace pywinrt
         w.write("#include \"pch.h\"\n");
         w.write("#include \"py.%.h\"\n", ns);
 
-        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.classes)(w);
-        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.interfaces)(w);
-        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.structs)(w);
+        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.classes())(w);
+        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.interfaces())(w);
+        settings.filter.bind_each<write_winrt_type_specialization_storage>(members.structs())(w);
 
         if (ns == "Windows.Foundation")
         {
             w.write(strings::custom_struct_convert);
         }
-        settings.filter.bind_each<write_struct_convert_functions>(members.structs)(w);
+        settings.filter.bind_each<write_struct_convert_functions>(members.structs())(w);
 
         auto segments = get_dotted_name_segments(ns);
         w.write("\n\nnamespace py::cpp::%\n{", bind_list("::", segments));
         {
             writer::indent_guard g{ w };
 
-            settings.filter.bind_each<write_inspectable_type>(members.classes)(w);
-            settings.filter.bind_each<write_inspectable_type>(members.interfaces)(w);
-            settings.filter.bind_each<write_struct>(members.structs)(w);
+            settings.filter.bind_each<write_inspectable_type>(members.classes())(w);
+            settings.filter.bind_each<write_inspectable_type>(members.interfaces())(w);
+            settings.filter.bind_each<write_struct>(members.structs())(w);
             write_namespace_initialization(w, ns, members);
         }
         w.write("} // py::cpp::%\n", bind_list("::", segments));
@@ -183,7 +183,7 @@ namespace pywinrt
 
         w.write("import typing, %\n", module_name);
 
-        if (settings.filter.includes(members.enums))
+        if (settings.filter.includes(members.enums()))
         {
             w.write("import enum\n");
         }
@@ -191,11 +191,11 @@ namespace pywinrt
         w.write("\n_ns_module = %._import_ns_module(\"%\")\n", module_name, ns);
 
         w.write_each<write_python_import_namespace>(needed_namespaces);
-        settings.filter.bind_each<write_python_enum>(members.enums)(w);
+        settings.filter.bind_each<write_python_enum>(members.enums())(w);
         w.write("\n");
-        settings.filter.bind_each<write_python_import_type>(members.structs)(w);
-        settings.filter.bind_each<write_python_import_type>(members.classes)(w);
-        settings.filter.bind_each<write_python_import_type>(members.interfaces)(w);
+        settings.filter.bind_each<write_python_import_type>(members.structs())(w);
+        settings.filter.bind_each<write_python_import_type>(members.classes())(w);
+        settings.filter.bind_each<write_python_import_type>(members.interfaces())(w);
 
         w.flush_to_file(folder / "__init__.py");
     }
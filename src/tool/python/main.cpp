@@ -23,6 +23,8 @@ namespace pywinrt
         { "exclude", 0, cmd::option::no_max, "<prefix>", "One or more prefixes to exclude from projection" },
         { "verbose", 0, 0, {}, "Show detailed progress information" },
         { "module", 0, 1, "<name>", "Name of generated projection. Defaults to winrt."},
+        { "snapshot", 0, 1, "<path>", "Cache indexed metadata in a snapshot file to speed up later runs" },
+        { "jobs", 0, 1, "<count>", "Limit concurrent tasks (defaults to make jobserver or processor count)" },
         { "help", 0, cmd::option::no_max, {}, "Show detailed help" },
     };
 
@@ -73,6 +75,8 @@ Where <spec> is one or more of:
 
         settings.verbose = args.exists("verbose");
         settings.module = args.value("module", "winrt");
+        settings.snapshot = args.value("snapshot");
+        task_group::configure(get_task_group_options(args.value("jobs")));
         settings.input = args.files("input", database::is_database);
 
         for (auto && include : args.values("include"))
@@ -99,11 +103,11 @@ Where <spec> is one or more of:
     bool has_projected_types(cache::namespace_members const& members)
     {
         return
-            !members.interfaces.empty() ||
-            !members.classes.empty() ||
-            !members.enums.empty() ||
-            !members.structs.empty() ||
-            !members.delegates.empty();
+            !members.interfaces().empty() ||
+            !members.classes().empty() ||
+            !members.enums().empty() ||
+            !members.structs().empty() ||
+            !members.delegates().empty();
     }
 
     int run(int const argc, char** argv)
@@ -115,7 +119,11 @@ Where <spec> is one or more of:
         {
             auto start = get_start_time();
             process_args(argc, argv);
-            cache c{ get_files_to_cache() };
+            cache_options options;
+            options.parallel = true;
+            options.deferred = true;
+            options.snapshot = settings.snapshot;
+            cache c{ get_files_to_cache(), options };
             settings.filter = { settings.include, settings.exclude };
 
             if (settings.verbose)
@@ -147,8 +155,10 @@ Where <spec> is one or more of:
 
             std::vector<std::string> generated_namespaces{};
 
-            for (auto&&[ns, members] : c.namespaces())
+            for (auto&& entry : get_namespaces_by_size(c))
             {
+                auto&&[ns, members] = *entry;
+
                 if (!has_projected_types(members) || !settings.filter.includes(members))
                 {
                     continue;
@@ -166,7 +176,7 @@ Where <spec> is one or more of:
                 
                 create_directories(ns_dir);
 
-                group.add([&src_dir, ns_dir, ns = ns, members = members]
+                group.add([&src_dir, ns_dir, ns = ns, &members = members]
                 {
                     auto namespaces = write_namespace_cpp(src_dir, ns, members);
                     write_namespace_h(src_dir, ns, namespaces, members);
@@ -176,6 +186,7 @@ Where <spec> is one or more of:
 
             group.get();
 
+            std::sort(generated_namespaces.begin(), generated_namespaces.end());
             write_setup_py(settings.output_folder, generated_namespaces);
 
             if (settings.verbose)
@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "settings.h"
+
+namespace xlang
+{
+    using namespace std::filesystem;
+    using namespace text;
+    using namespace meta::reader;
+
+    settings_type settings;
+
+    struct usage_exception {};
+
+    struct writer : writer_base<writer>
+    {
+    };
+
+    static constexpr cmd::option options[]
+    {
+        { "input", 0, cmd::option::no_max, "<spec>", "Metadata to merge into the output" },
+        { "reference", 0, cmd::option::no_max, "<spec>", "Metadata to reference from the output" },
+        { "output", 1, 1, "<path>", "Location of merged winmd file" },
+        { "name", 0, 1, "<name>", "Specify explicit assembly name (defaults to output file name)" },
+        { "include", 0, cmd::option::no_max, "<prefix>", "One or more prefixes to include in output" },
+        { "exclude", 0, cmd::option::no_max, "<prefix>", "One or more prefixes to exclude from output" },
+        { "snapshot", 0, 1, "<path>", "Cache indexed metadata in a snapshot file to speed up later runs" },
+        { "jobs", 0, 1, "<count>", "Limit concurrent tasks (defaults to make jobserver or processor count)" },
+        { "verbose", 0, 0, {}, "Show detailed progress information" },
+        { "help", 0, cmd::option::no_max, {}, "Show detailed help" },
+    };
+
+    static void print_usage(writer& w)
+    {
+        static auto printColumns = [](writer& w, std::string_view const& col1, std::string_view const& col2)
+        {
+            w.write_printf("  %-20s%s\n", col1.data(), col2.data());
+        };
+
+        static auto printOption = [](writer& w, cmd::option const& opt)
+        {
+            if(opt.desc.empty())
+            {
+                return;
+            }
+            printColumns(w, w.write_temp("-% %", opt.name, opt.arg), opt.desc);
+        };
+
+        auto format = R"(
+winmdmerge v%
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+  winmdmerge.exe [options...]
+
+Options:
+
+%  ^@<path>             Response file containing command line options
+
+Where <spec> is one or more of:
+
+  path                Path to winmd file or recursively scanned folder
+  local               Local ^%WinDir^%\System32\WinMetadata folder
+  sdk[+]              Current version of Windows SDK [with extensions]
+  10.0.12345.0[+]     Specific version of Windows SDK [with extensions]
+)";
+        w.write(format, XLANG_VERSION_STRING, bind_each(printOption, options));
+    }
+
+    static void process_args(int const argc, char** argv)
+    {
+        cmd::reader args{ argc, argv, options };
+
+        if (!args || args.exists("help"))
+        {
+            throw usage_exception{};
+        }
+
+        settings.verbose = args.exists("verbose");
+        settings.snapshot = args.value("snapshot");
+        task_group::configure(get_task_group_options(args.value("jobs")));
+
+        settings.input = args.files("input", database::is_database);
+        settings.reference = args.files("reference", database::is_database);
+
+        for (auto && include : args.values("include"))
+        {
+            settings.include.insert(include);
+        }
+
+        for (auto && exclude : args.values("exclude"))
+        {
+            settings.exclude.insert(exclude);
+        }
+
+        auto output = absolute(args.value("output"));
+        create_directories(output.parent_path());
+        settings.output = output.string();
+        settings.name = args.value("name", output.stem().string());
+    }
+
+    static auto get_files_to_cache()
+    {
+        std::vector<std::string> files;
+        files.insert(files.end(), settings.input.begin(), settings.input.end());
+        files.insert(files.end(), settings.reference.begin(), settings.reference.end());
+        return files;
+    }
+
+    static auto get_elapsed_time(std::chrono::time_point<std::chrono::high_resolution_clock> const& start)
+    {
+        return std::chrono::duration_cast<std::chrono::duration<int64_t, std::milli>>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    static int run(int const argc, char** argv)
+    {
+        int result{};
+        writer w;
+
+        try
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            process_args(argc, argv);
+
+            cache_options options;
+            options.parallel = true;
+
+            // Types are merged by database, so namespaces are never categorized.
+            options.deferred = true;
+            options.snapshot = settings.snapshot;
+            cache c{ get_files_to_cache(), options };
+            settings.filter = { settings.include, settings.exclude };
+
+            meta::writer::type_walker walker{ c };
+
+            for (auto&& db : c.databases())
+            {
+                if (settings.input.count(db.path()))
+                {
+                    walker.add_input(db);
+                }
+            }
+
+            for (auto&& db : c.databases())
+            {
+                if (!settings.input.count(db.path()))
+                {
+                    continue;
+                }
+
+                for (auto&& type : db.TypeDef)
+                {
+                    if (type.TypeNamespace().empty() || !settings.filter.includes(type))
+                    {
+                        continue;
+                    }
+
+                    walker.add(type);
+                }
+            }
+
+            walker.run();
+
+            if (settings.verbose)
+            {
+                w.write(" tool:  %\n", canonical(argv[0]).string());
+                w.write(" ver:   %\n", XLANG_VERSION_STRING);
+
+                for (auto&& file : settings.input)
+                {
+                    w.write(" in:    %\n", file);
+                }
+
+                for (auto&& file : settings.reference)
+                {
+                    w.write(" ref:   %\n", file);
+                }
+
+                w.write(" out:   %\n", settings.output);
+                w.write(" types: %\n", walker.names().size());
+            }
+
+            w.flush_to_console();
+
+            meta::writer::merge_writer merge{ settings.name };
+
+            merge.filter([&](TypeDef const& type)
+            {
+                return walker.includes(type);
+            });
+
+            for (auto&& db : c.databases())
+            {
+                if (settings.input.count(db.path()))
+                {
+                    merge.add(db);
+                }
+            }
+
+            merge.save_to_file(settings.output);
+
+            if (settings.verbose)
+            {
+                w.write(" time:  %ms\n", get_elapsed_time(start));
+            }
+        }
+        catch (usage_exception const&)
+        {
+            print_usage(w);
+        }
+        catch (std::exception const& e)
+        {
+            w.write(" error: %\n", e.what());
+            result = 1;
+        }
+
+        w.flush_to_console();
+        return result;
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    return xlang::run(argc, argv);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace xlang
+{
+    struct settings_type
+    {
+        std::set<std::string> input;
+        std::set<std::string> reference;
+
+        std::string output;
+        std::string name;
+        bool verbose{};
+        std::string snapshot;
+
+        std::set<std::string> include;
+        std::set<std::string> exclude;
+        meta::reader::filter filter;
+    };
+
+    extern settings_type settings;
+}